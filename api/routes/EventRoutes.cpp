@@ -8,6 +8,7 @@
 
 using namespace std::chrono;
 using ApiSerialization::eventToJson;
+using ApiSerialization::eventsResponse;
 
 namespace EventRoutes
 {
@@ -18,7 +19,7 @@ namespace EventRoutes
         server.Get("/events", [&model](const httplib::Request &req, httplib::Response &res)
                    {
         
-        nlohmann::json out;
+        std::string body;
         try {
             bool expanded = req.has_param("expanded") && (req.get_param_value("expanded") == "true" || req.get_param_value("expanded") == "1");
             auto now = system_clock::now();
@@ -28,21 +29,50 @@ namespace EventRoutes
             if (req.has_param("start")) start = TimeUtils::parseTimePoint(req.get_param_value("start"));
             if (req.has_param("end")) end = TimeUtils::parseTimePoint(req.get_param_value("end"));
 
-            nlohmann::json data = nlohmann::json::array();
+            // Taken before the read, so a change racing with it is sent again
+            // by /events/changes rather than missed
+            auto version = model.changeVersion();
+            // Serialize straight from the stored events; no per-event copies
             if (expanded) {
-                auto events = model.getEventsInRangeExpanded(start, end);
-                for (const auto &ev : events) data.push_back(eventToJson(ev));
+                body = eventsResponse(model.getOccurrencesInRange(start, end), version);
             } else {
                 // Seed view (non-expanded), use far-future cutoff as before
-                auto events = model.getEvents(-1, defaultEnd);
-                for (const auto &ev : events) data.push_back(eventToJson(ev));
+                body = eventsResponse(model.getEventPtrs(-1, defaultEnd), version);
             }
-            out["status"] = "ok";
-            out["data"] = data;
         } catch (const std::exception &ex) {
-            out = { {"status","error"},{"message","Invalid input"} };
+            body = nlohmann::json{ {"status","error"},{"message","Invalid input"} }.dump();
         }
-        res.set_content(out.dump(), "application/json"); });
+        res.set_content(body, "application/json"); });
+
+        // Changes since a version from /events or an earlier call; resync
+        // means the log no longer reaches back that far
+        server.Get("/events/changes", [&model](const httplib::Request &req, httplib::Response &res)
+                   {
+        
+        std::string body;
+        try {
+            uint64_t since = req.has_param("since") ? std::stoull(req.get_param_value("since")) : 0;
+            auto changes = model.getChangesSince(since);
+            body.reserve(64 + changes.upserts.size() * 160 + changes.deletes.size() * 32);
+            body += "{\"data\":{\"deletes\":[";
+            for (size_t i = 0; i < changes.deletes.size(); ++i) {
+                if (i > 0) body += ',';
+                ApiSerialization::appendJsonString(body, changes.deletes[i]);
+            }
+            body += "],\"upserts\":[";
+            for (size_t i = 0; i < changes.upserts.size(); ++i) {
+                if (i > 0) body += ',';
+                ApiSerialization::appendEventJson(body, *changes.upserts[i]);
+            }
+            body += "]},\"resync\":";
+            body += changes.resync ? "true" : "false";
+            body += ",\"status\":\"ok\",\"version\":";
+            body += std::to_string(changes.version);
+            body += '}';
+        } catch (const std::exception &ex) {
+            body = nlohmann::json{ {"status","error"},{"message","Invalid input"} }.dump();
+        }
+        res.set_content(body, "application/json"); });
 
         // Next event
         server.Get("/events/next", [&model](const httplib::Request &, httplib::Response &res)
@@ -65,74 +95,62 @@ namespace EventRoutes
         server.Get("/events/search", [&model](const httplib::Request &req, httplib::Response &res)
                    {
         
-        nlohmann::json out;
+        std::string body;
         try {
             std::string query = req.get_param_value("q");
             int maxResults = -1;
             if (req.has_param("max")) {
                 maxResults = std::stoi(req.get_param_value("max"));
             }
-            auto events = model.searchEvents(query, maxResults);
-            nlohmann::json data = nlohmann::json::array();
-            for (const auto &ev : events) {
-                data.push_back(eventToJson(ev));
-            }
-            out["status"] = "ok";
-            out["data"] = data;
+            body = eventsResponse(model.searchEventPtrs(query, maxResults));
         } catch (const std::exception &ex) {
-            out = { {"status","error"},{"message","Invalid input"} };
+            body = nlohmann::json{ {"status","error"},{"message","Invalid input"} }.dump();
         }
-        res.set_content(out.dump(), "application/json"); });
+        res.set_content(body, "application/json"); });
 
         // Events in range
         server.Get(R"(/events/range/(\d{4}-\d{2}-\d{2})/(\d{4}-\d{2}-\d{2}))", [&model](const httplib::Request &req, httplib::Response &res)
                    {
         
-        nlohmann::json out;
+        std::string body;
         try {
             auto start = TimeUtils::parseDate(req.matches[1]);
             auto end = TimeUtils::parseDate(req.matches[2]) + hours(24);
-            auto events = model.getEventsInRangeExpanded(start, end);
-            nlohmann::json data = nlohmann::json::array();
-            for (const auto &ev : events) {
-                data.push_back(eventToJson(ev));
-            }
-            out["status"] = "ok";
-            out["data"] = data;
+            body = eventsResponse(model.getOccurrencesInRange(start, end));
         } catch (const std::exception &ex) {
-            out = { {"status","error"},{"message","Invalid input"} };
+            body = nlohmann::json{ {"status","error"},{"message","Invalid input"} }.dump();
         }
-        res.set_content(out.dump(), "application/json"); });
+        res.set_content(body, "application/json"); });
 
         // Events by duration
         server.Get("/events/duration", [&model](const httplib::Request &req, httplib::Response &res)
                    {
         
-        nlohmann::json out;
+        std::string body;
         try {
             int minMinutes = 0;
             int maxMinutes = INT_MAX;
             if (req.has_param("min")) minMinutes = std::stoi(req.get_param_value("min"));
             if (req.has_param("max")) maxMinutes = std::stoi(req.get_param_value("max"));
-            auto events = model.getEventsByDuration(minMinutes, maxMinutes);
-            nlohmann::json data = nlohmann::json::array();
-            for (const auto &ev : events) data.push_back(eventToJson(ev));
-            out["status"] = "ok";
-            out["data"] = data;
+            body = eventsResponse(model.getEventPtrsByDuration(minMinutes, maxMinutes));
         } catch (const std::exception &ex) {
-            out = { {"status","error"},{"message","Invalid input"} };
+            body = nlohmann::json{ {"status","error"},{"message","Invalid input"} }.dump();
         }
-        res.set_content(out.dump(), "application/json"); });
+        res.set_content(body, "application/json"); });
 
         // Categories list
-        server.Get("/categories", [&model](const httplib::Request &, httplib::Response &res)
+        server.Get("/categories", [&model](const httplib::Request &req, httplib::Response &res)
                    {
         
         nlohmann::json out;
         try {
-            auto categories = model.getCategories();
             nlohmann::json data = nlohmann::json::array();
-            for (const auto &cat : categories) data.push_back(cat);
+            if (req.has_param("counts") && req.get_param_value("counts") == "true") {
+                for (const auto &kv : model.getCategoryCounts())
+                    data.push_back({{"name", kv.first}, {"count", kv.second}});
+            } else {
+                for (const auto &cat : model.getCategories()) data.push_back(cat);
+            }
             out["status"] = "ok";
             out["data"] = data;
         } catch (const std::exception &ex) {
@@ -144,69 +162,53 @@ namespace EventRoutes
         server.Get(R"(/events/category/(.+))", [&model](const httplib::Request &req, httplib::Response &res)
                    {
         
-        nlohmann::json out;
+        std::string body;
         try {
             std::string category = req.matches[1];
-            auto events = model.getEventsByCategory(category);
-            nlohmann::json data = nlohmann::json::array();
-            for (const auto &ev : events) data.push_back(eventToJson(ev));
-            out["status"] = "ok";
-            out["data"] = data;
+            body = eventsResponse(model.getEventPtrsByCategory(category));
         } catch (const std::exception &ex) {
-            out = { {"status","error"},{"message","Invalid input"} };
+            body = nlohmann::json{ {"status","error"},{"message","Invalid input"} }.dump();
         }
-        res.set_content(out.dump(), "application/json"); });
+        res.set_content(body, "application/json"); });
 
         // Events by day
         server.Get(R"(/events/day/(\d{4}-\d{2}-\d{2}))", [&model](const httplib::Request &req, httplib::Response &res)
                    {
         
-        nlohmann::json out;
+        std::string body;
         try {
             auto day = TimeUtils::parseDate(req.matches[1]);
-            auto events = model.getEventsOnDay(day);
-            nlohmann::json data = nlohmann::json::array();
-            for (const auto &ev : events) data.push_back(eventToJson(ev));
-            out["status"] = "ok";
-            out["data"] = data;
+            body = eventsResponse(model.getOccurrencesOnDay(day));
         } catch (const std::exception &ex) {
-            out = { {"status","error"},{"message","Invalid input"} };
+            body = nlohmann::json{ {"status","error"},{"message","Invalid input"} }.dump();
         }
-        res.set_content(out.dump(), "application/json"); });
+        res.set_content(body, "application/json"); });
 
         // Events by week
         server.Get(R"(/events/week/(\d{4}-\d{2}-\d{2}))", [&model](const httplib::Request &req, httplib::Response &res)
                    {
         
-        nlohmann::json out;
+        std::string body;
         try {
             auto day = TimeUtils::parseDate(req.matches[1]);
-            auto events = model.getEventsInWeek(day);
-            nlohmann::json data = nlohmann::json::array();
-            for (const auto &ev : events) data.push_back(eventToJson(ev));
-            out["status"] = "ok";
-            out["data"] = data;
+            body = eventsResponse(model.getOccurrencesInWeek(day));
         } catch (const std::exception &ex) {
-            out = { {"status","error"},{"message","Invalid input"} };
+            body = nlohmann::json{ {"status","error"},{"message","Invalid input"} }.dump();
         }
-        res.set_content(out.dump(), "application/json"); });
+        res.set_content(body, "application/json"); });
 
         // Events by month
         server.Get(R"(/events/month/(\d{4}-\d{2}))", [&model](const httplib::Request &req, httplib::Response &res)
                    {
         
-        nlohmann::json out;
+        std::string body;
         try {
             auto month = TimeUtils::parseMonth(req.matches[1]);
-            auto events = model.getEventsInMonth(month);
-            nlohmann::json data = nlohmann::json::array();
-            for (const auto &ev : events) data.push_back(eventToJson(ev));
-            out["status"] = "ok";
-            out["data"] = data;
+            body = eventsResponse(model.getOccurrencesInMonth(month));
         } catch (const std::exception &ex) {
-            out = { {"status","error"},{"message","Invalid input"} };
+            body = nlohmann::json{ {"status","error"},{"message","Invalid input"} }.dump();
         }
-        res.set_content(out.dump(), "application/json"); });
+        res.set_content(body, "application/json"); });
 
         // Create new event
         server.Post("/events", [&model, wake](const httplib::Request &req, httplib::Response &res)
@@ -300,12 +302,15 @@ namespace EventRoutes
         res.set_content(out.dump(), "application/json"); });
 
         // Deleted events
-        server.Get("/events/deleted", [&model](const httplib::Request &, httplib::Response &res)
+        server.Get("/events/deleted", [&model](const httplib::Request &req, httplib::Response &res)
                    {
         
         nlohmann::json out;
         try {
-            auto events = model.getDeletedEvents();
+            size_t offset = 0, limit = 0;
+            if (req.has_param("offset")) offset = std::stoul(req.get_param_value("offset"));
+            if (req.has_param("limit")) limit = std::stoul(req.get_param_value("limit"));
+            auto events = model.getDeletedEvents(offset, limit);
             nlohmann::json data = nlohmann::json::array();
             for (const auto &ev : events) data.push_back(eventToJson(ev));
             out["status"] = "ok";
@@ -6,6 +6,7 @@
 #include "../../model/recurrence/WeeklyRecurrence.h"
 #include "../../model/recurrence/MonthlyRecurrence.h"
 #include "../../model/recurrence/YearlyRecurrence.h"
+#include "../../model/recurrence/RRuleRecurrence.h"
 #include "../../utils/WeekDay.h"
 #include "../../utils/Sanitize.h"
 #include <iostream>
@@ -38,6 +39,14 @@ static std::shared_ptr<RecurrencePattern> parsePattern(const nlohmann::json &j,
         return std::make_shared<MonthlyRecurrence>(start, interval, maxOcc, end);
     } else if (type == "yearly") {
         return std::make_shared<YearlyRecurrence>(start, interval, maxOcc, end);
+    } else if (type == "rrule") {
+        std::vector<system_clock::time_point> exdates;
+        if (j.contains("exdates")) {
+            for (const auto &d : j["exdates"]) {
+                exdates.push_back(TimeUtils::parseTimePoint(d.get<std::string>()));
+            }
+        }
+        return std::make_shared<RRuleRecurrence>(start, j.at("rule").get<std::string>(), exdates);
     }
     throw std::runtime_error("Unknown recurrence type");
 }
@@ -1,9 +1,14 @@
 #pragma once
 #include "../../model/Event.h"
 #include "../../model/OneTimeEvent.h"
+#include "../../model/Occurrence.h"
 #include "../../utils/TimeUtils.h"
 #include "nlohmann/json.hpp"
 #include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace ApiSerialization {
     using json = nlohmann::json;
@@ -20,6 +25,93 @@ namespace ApiSerialization {
         return j;
     }
 
+    // Appends `s` as a JSON string literal, escaped the way json::dump() does.
+    inline void appendJsonString(std::string &out, const std::string &s) {
+        static const char hex[] = "0123456789abcdef";
+        out += '"';
+        for (char c : s) {
+            switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\b': out += "\\b"; break;
+                case '\f': out += "\\f"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        out += "\\u00";
+                        out += hex[(c >> 4) & 0xF];
+                        out += hex[c & 0xF];
+                    } else {
+                        out += c;
+                    }
+            }
+        }
+        out += '"';
+    }
+
+    // Same text as eventToJson(e).dump() for `e` starting at `start`,
+    // written straight into `out`.
+    inline void appendEventJson(std::string &out, const Event &e, system_clock::time_point start) {
+        out += "{\"category\":";
+        appendJsonString(out, e.getCategory());
+        out += ",\"description\":";
+        appendJsonString(out, e.getDescription());
+        out += ",\"duration\":";
+        out += std::to_string(duration_cast<seconds>(e.getDuration()).count());
+        out += ",\"id\":";
+        appendJsonString(out, e.getId());
+        out += ",\"time\":\"";
+        TimeUtils::appendTimePoint(out, start);
+        out += "\",\"title\":";
+        appendJsonString(out, e.getTitle());
+        out += '}';
+    }
+
+    inline void appendEventJson(std::string &out, const Event &e) {
+        appendEventJson(out, e, e.getTime());
+    }
+
+    // {"data":[...],"status":"ok"} for borrowed events, serialized from the
+    // stored objects without building a json tree.
+    // A non-zero `version` (Model::changeVersion() taken before the read)
+    // is added as "version", for resuming with GET /events/changes.
+    inline std::string eventsResponse(const std::vector<std::shared_ptr<const Event>> &events, uint64_t version = 0) {
+        std::string out;
+        out.reserve(32 + events.size() * 160);
+        out += "{\"data\":[";
+        for (size_t i = 0; i < events.size(); ++i) {
+            if (i > 0) out += ',';
+            appendEventJson(out, *events[i]);
+        }
+        out += "],\"status\":\"ok\"";
+        if (version != 0) {
+            out += ",\"version\":";
+            out += std::to_string(version);
+        }
+        out += '}';
+        return out;
+    }
+
+    // Same shape for an expanded schedule; text comes from each series.
+    inline std::string eventsResponse(const std::vector<Occurrence> &occurrences, uint64_t version = 0) {
+        std::string out;
+        out.reserve(32 + occurrences.size() * 160);
+        out += "{\"data\":[";
+        for (size_t i = 0; i < occurrences.size(); ++i) {
+            if (i > 0) out += ',';
+            appendEventJson(out, occurrences[i].event(), occurrences[i].start);
+        }
+        out += "],\"status\":\"ok\"";
+        if (version != 0) {
+            out += ",\"version\":";
+            out += std::to_string(version);
+        }
+        out += '}';
+        return out;
+    }
+
     inline json timeSlotToJson(const TimeSlot &slot) {
         json j;
         j["start"] = TimeUtils::formatTimePoint(slot.start);
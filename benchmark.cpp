@@ -1,7 +1,11 @@
 #include "model/Model.h"
 #include "database/SQLiteScheduleDatabase.h"
+#include "database/WriteBehindScheduleDatabase.h"
 #include "api/UnifiedApiServer.h"
 #include "utils/EnvLoader.h"
+#include "utils/EditDistance.h"
+#include "model/recurrence/WeeklyRecurrence.h"
+#include "model/recurrence/RRuleRecurrence.h"
 #include <iostream>
 #include <chrono>
 #include <thread>
@@ -11,6 +15,12 @@
 #include <sstream>
 #include <random>
 #include <iomanip>
+#include <atomic>
+#include <cstdio>
+#include <algorithm>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
 
 using namespace std::chrono;
 
@@ -56,6 +66,18 @@ HTTPResponse httpGet(const std::string& url) {
     return response;
 }
 
+// Database stand-in that costs roughly one fsync per write
+class SlowDatabase : public IScheduleDatabase {
+public:
+    explicit SlowDatabase(microseconds latency) : latency_(latency) {}
+    bool addEvent(const Event&) override { std::this_thread::sleep_for(latency_); return true; }
+    bool removeEvent(const std::string&) override { std::this_thread::sleep_for(latency_); return true; }
+    bool removeAllEvents() override { return true; }
+    std::vector<std::unique_ptr<Event>> getAllEvents() const override { return {}; }
+private:
+    microseconds latency_;
+};
+
 class UnifiedBenchmark {
 private:
     std::unique_ptr<SQLiteScheduleDatabase> db_;
@@ -164,6 +186,348 @@ public:
         model_->removeAllEvents();
     }
     
+    // ID index scaling: lookup/update/delete cost should not depend on model size
+    void runIndexBenchmarks() {
+        std::cout << "\n🔑 ID INDEX BENCHMARKS\n";
+        std::cout << "=====================\n";
+        std::cout << std::setw(10) << "events" << std::setw(14) << "lookup ns"
+                  << std::setw(14) << "update ns" << std::setw(14) << "conflict ns"
+                  << std::setw(14) << "delete ns" << "\n";
+
+        const int NUM_OPS = 10000;
+        for (int size : {1000, 10000, 100000, 1000000}) {
+            // In-memory model only so the numbers reflect the index, not SQLite
+            Model model;
+            auto base = system_clock::now();
+            for (int i = 0; i < size; i++) {
+                Event event("idx_" + std::to_string(i), "Index benchmark", "Event " + std::to_string(i),
+                            base + minutes(i), minutes(30));
+                model.addEvent(event);
+            }
+
+            std::mt19937 rng(42);
+            std::uniform_int_distribution<int> pick(0, size - 1);
+            std::vector<std::string> ids;
+            ids.reserve(NUM_OPS);
+            for (int i = 0; i < NUM_OPS; i++) {
+                ids.push_back("idx_" + std::to_string(pick(rng)));
+            }
+
+            auto t0 = high_resolution_clock::now();
+            for (const auto& id : ids) {
+                auto found = model.getEventById(id);
+            }
+            auto t1 = high_resolution_clock::now();
+            for (const auto& id : ids) {
+                model.updateEventFields(id, {{"title", "updated"}});
+            }
+            auto t2 = high_resolution_clock::now();
+            std::uniform_int_distribution<int> offset(0, size);
+            size_t conflictsFound = 0;
+            for (int i = 0; i < NUM_OPS; i++) {
+                conflictsFound += model.getConflicts(base + minutes(offset(rng)), minutes(45)).size();
+            }
+            auto t3 = high_resolution_clock::now();
+            // Delete a distinct set of IDs so every call actually removes an event
+            int deletes = std::min(NUM_OPS, size);
+            for (int i = 0; i < deletes; i++) {
+                model.removeEvent("idx_" + std::to_string(i));
+            }
+            auto t4 = high_resolution_clock::now();
+
+            auto perOp = [](auto a, auto b, int n) {
+                return duration_cast<nanoseconds>(b - a).count() / n;
+            };
+            std::cout << std::setw(10) << size
+                      << std::setw(14) << perOp(t0, t1, NUM_OPS)
+                      << std::setw(14) << perOp(t1, t2, NUM_OPS)
+                      << std::setw(14) << perOp(t2, t3, NUM_OPS)
+                      << std::setw(14) << perOp(t3, t4, deletes) << "\n";
+        }
+    }
+    
+    // Read latency while writers hammer a slow database
+    void runContentionBenchmarks() {
+        std::cout << "\n🔒 READ/WRITE CONTENTION BENCHMARKS\n";
+        std::cout << "==================================\n";
+
+        SlowDatabase db(microseconds(2000));
+        Model model(&db);
+        auto base = system_clock::now();
+        for (int i = 0; i < 10000; i++) {
+            Event event("seed_" + std::to_string(i), "Contention benchmark", "Seed " + std::to_string(i),
+                        base + minutes(i * 10), minutes(30));
+            model.addEvent(event);
+        }
+
+        auto measure = [&](int writerThreads) {
+            std::atomic<bool> stop{false};
+            std::vector<std::thread> writers;
+            for (int w = 0; w < writerThreads; w++) {
+                writers.emplace_back([&, w] {
+                    for (int i = 0; !stop; i++) {
+                        std::string id = "w" + std::to_string(w) + "_" + std::to_string(i);
+                        Event event(id, "Write storm", "Write " + std::to_string(i),
+                                    base + minutes((i * 37) % 100000), minutes(15));
+                        model.addEvent(event);
+                        model.removeEvent(id);
+                    }
+                });
+            }
+
+            // Leave a core for the writers so scheduler noise doesn't dominate
+            const int READERS = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+            const auto runFor = seconds(2);
+            std::vector<std::vector<double>> latencies(READERS);
+            std::vector<std::thread> readers;
+            for (int r = 0; r < READERS; r++) {
+                readers.emplace_back([&, r] {
+                    std::mt19937 rng(r);
+                    std::uniform_int_distribution<int> day(0, 60);
+                    auto until = steady_clock::now() + runFor;
+                    while (steady_clock::now() < until) {
+                        auto from = base + hours(24 * day(rng));
+                        auto t0 = high_resolution_clock::now();
+                        auto events = model.getEventsInRange(from, from + hours(24));
+                        auto t1 = high_resolution_clock::now();
+                        latencies[r].push_back(duration_cast<nanoseconds>(t1 - t0).count() / 1000.0);
+                    }
+                });
+            }
+            for (auto& t : readers) t.join();
+            stop = true;
+            for (auto& t : writers) t.join();
+
+            std::vector<double> all;
+            for (auto& l : latencies) all.insert(all.end(), l.begin(), l.end());
+            std::sort(all.begin(), all.end());
+            auto pct = [&](double p) { return all[static_cast<size_t>(p * (all.size() - 1))]; };
+            std::cout << std::setw(10) << writerThreads << std::setw(12) << all.size()
+                      << std::fixed << std::setprecision(1)
+                      << std::setw(12) << pct(0.50) << std::setw(12) << pct(0.99)
+                      << std::setw(12) << all.back() << "\n";
+        };
+
+        std::cout << std::setw(10) << "writers" << std::setw(12) << "reads"
+                  << std::setw(12) << "p50 us" << std::setw(12) << "p99 us" << std::setw(12) << "max us" << "\n";
+        for (int writers : {0, 1, 4}) {
+            measure(writers);
+        }
+    }
+
+    // SQLite write throughput: one commit per row vs write-behind batches
+    void runPersistenceBenchmarks() {
+        std::cout << "\n💾 PERSISTENCE BENCHMARKS\n";
+        std::cout << "========================\n";
+
+        const int NUM_WRITES = 2000;
+        auto run = [&](const std::string& label, bool writeBehind) {
+            const char* path = "benchmark_persist.db";
+            std::remove(path);
+            auto sqlite = std::make_shared<SQLiteScheduleDatabase>(path);
+            std::shared_ptr<IScheduleDatabase> db = sqlite;
+            if (writeBehind) {
+                db = std::make_shared<WriteBehindScheduleDatabase>(sqlite, milliseconds(50), 256);
+            }
+            Model model(db.get());
+            auto base = system_clock::now();
+            auto start = high_resolution_clock::now();
+            for (int i = 0; i < NUM_WRITES; i++) {
+                Event event("persist_" + std::to_string(i), "Persistence benchmark", "Event " + std::to_string(i),
+                            base + minutes(i), minutes(30));
+                model.addEvent(event);
+            }
+            auto accepted = high_resolution_clock::now();
+            model.flush();
+            auto durable = high_resolution_clock::now();
+
+            double acceptMs = duration_cast<microseconds>(accepted - start).count() / 1000.0;
+            double durableMs = duration_cast<microseconds>(durable - start).count() / 1000.0;
+            std::cout << std::setw(14) << label << std::fixed << std::setprecision(1)
+                      << std::setw(14) << acceptMs << std::setw(14) << durableMs
+                      << std::setw(14) << (NUM_WRITES / (durableMs / 1000.0)) << "\n";
+            std::remove(path);
+        };
+
+        std::cout << std::setw(14) << "mode" << std::setw(14) << "accept ms"
+                  << std::setw(14) << "durable ms" << std::setw(14) << "writes/s" << "\n";
+        run("synchronous", false);
+        run("write-behind", true);
+    }
+
+    // Expanding ten years of occurrences: compiled RRULEs vs the built-in patterns
+    void runRecurrenceBenchmarks() {
+        std::cout << "\n🔁 RECURRENCE BENCHMARKS\n";
+        std::cout << "=======================\n";
+
+        auto start = system_clock::now() - hours(24 * 365 * 20);
+        auto from = system_clock::now();
+        auto to = from + hours(24 * 365 * 10);
+        WeeklyRecurrence weekly(start, {Weekday::Monday, Weekday::Tuesday, Weekday::Wednesday, Weekday::Thursday,
+                                        Weekday::Friday}, 1);
+        RRuleRecurrence weekdays(start, "FREQ=WEEKLY;BYDAY=MO,TU,WE,TH,FR;WKST=SU");
+        RRuleRecurrence lastWeekday(start, "FREQ=MONTHLY;BYDAY=MO,TU,WE,TH,FR;BYSETPOS=-1");
+        RRuleRecurrence secondTuesday(start, "FREQ=MONTHLY;BYDAY=2TU");
+
+        const int ROUNDS = 200;
+        auto run = [&](const std::string& label, const RecurrencePattern& pattern) {
+            size_t count = 0;
+            auto t0 = high_resolution_clock::now();
+            for (int r = 0; r < ROUNDS; r++) {
+                for (auto t : pattern.occurrencesBetween(from, to)) {
+                    (void)t;
+                    ++count;
+                }
+            }
+            double us = duration_cast<nanoseconds>(high_resolution_clock::now() - t0).count() / 1000.0 / ROUNDS;
+            std::cout << std::setw(28) << label << std::setw(14) << count / ROUNDS
+                      << std::fixed << std::setprecision(1) << std::setw(14) << us << "\n";
+        };
+
+        std::cout << std::setw(28) << "pattern" << std::setw(14) << "occurrences" << std::setw(14) << "us" << "\n";
+        run("weekly weekdays", weekly);
+        run("RRULE weekdays", weekdays);
+        run("RRULE last weekday", lastWeekday);
+        run("RRULE second Tuesday", secondTuesday);
+    }
+
+    // Full-scan throughput and resident bytes per event for the in-memory store
+    void runLayoutBenchmarks() {
+        std::cout << "\n🧱 EVENT LAYOUT BENCHMARKS\n";
+        std::cout << "=========================\n";
+        std::cout << std::setw(10) << "events" << std::setw(14) << "bytes/event"
+                  << std::setw(16) << "duration ns/ev" << std::setw(16) << "window ns/ev" << "\n";
+
+        auto heapBytes = [] {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+            return static_cast<double>(mallinfo2().uordblks);
+#else
+            return 0.0;
+#endif
+        };
+
+        for (int size : {100000, 1000000}) {
+            double before = heapBytes();
+            auto model = std::make_unique<Model>();
+            auto base = system_clock::now();
+            for (int i = 0; i < size; i++) {
+                Event event("lay_" + std::to_string(i), "Layout benchmark description", "Event " + std::to_string(i),
+                            base + minutes(i), minutes(15 + i % 60), "category_" + std::to_string(i % 16));
+                model->addEvent(event);
+            }
+            double perEvent = (heapBytes() - before) / size;
+
+            // Both queries visit every event but return almost nothing, so the
+            // cost is the walk itself rather than copying results out
+            const int ROUNDS = 5;
+            auto t0 = high_resolution_clock::now();
+            size_t hits = 0;
+            for (int r = 0; r < ROUNDS; r++) {
+                hits += model->getEventsByDuration(74, 74).size();
+            }
+            auto t1 = high_resolution_clock::now();
+            for (int r = 0; r < ROUNDS; r++) {
+                auto from = base + minutes(size - 10);
+                hits += model->getEventsInRangeExpanded(from, from + minutes(5)).size();
+            }
+            auto t2 = high_resolution_clock::now();
+
+            auto nsPerEvent = [&](auto a, auto b) {
+                return static_cast<double>(duration_cast<nanoseconds>(b - a).count()) / (static_cast<double>(size) * ROUNDS);
+            };
+            std::cout << std::setw(10) << size << std::fixed << std::setprecision(1)
+                      << std::setw(14) << perEvent
+                      << std::setw(16) << nsPerEvent(t0, t1)
+                      << std::setw(16) << nsPerEvent(t1, t2)
+                      << "   (" << hits << " hits)\n";
+        }
+    }
+
+    void runSearchBenchmarks() {
+        std::cout << "\n🔎 SEARCH BENCHMARKS\n";
+        std::cout << "===================\n";
+
+        // Similarity test as searchEvents used to run it: full DP, two
+        // vectors per call, ratio compared against 0.5
+        auto fullSimilarity = [](const std::string &a, const std::string &b) {
+            std::vector<int> prev(b.size() + 1), col(b.size() + 1);
+            for (size_t j = 0; j <= b.size(); ++j) prev[j] = static_cast<int>(j);
+            for (size_t i = 0; i < a.size(); ++i) {
+                col[0] = static_cast<int>(i + 1);
+                for (size_t j = 0; j < b.size(); ++j)
+                    col[j + 1] = std::min({prev[j + 1] + 1, col[j] + 1, prev[j] + (a[i] == b[j] ? 0 : 1)});
+                prev.swap(col);
+            }
+            int maxLen = static_cast<int>(std::max(a.size(), b.size()));
+            return maxLen == 0 ? 1.0 : 1.0 - static_cast<double>(prev[b.size()]) / maxLen;
+        };
+
+        std::mt19937 rng(42);
+        const char *alphabet = "abcdefghijklmnopqrstuvwxyz0123456789";
+        auto word = [&](size_t minLen, size_t maxLen) {
+            std::string w(minLen + rng() % (maxLen - minLen + 1), 'a');
+            for (auto &c : w) c = alphabet[rng() % 36];
+            return w;
+        };
+
+        std::cout << std::setw(12) << "word length" << std::setw(14) << "full DP ns"
+                  << std::setw(14) << "bounded ns" << std::setw(10) << "speedup" << "\n";
+        for (auto range : {std::make_pair(3, 8), std::make_pair(8, 16), std::make_pair(40, 64)}) {
+            const int QUERIES = 200, WORDS = 500;
+            std::vector<std::string> queries, words;
+            for (int i = 0; i < QUERIES; i++) queries.push_back(word(range.first, range.second));
+            for (int i = 0; i < WORDS; i++) words.push_back(word(range.first, range.second));
+
+            size_t fullHits = 0, boundedHits = 0;
+            auto t0 = high_resolution_clock::now();
+            for (const auto &q : queries)
+                for (const auto &w : words)
+                    fullHits += fullSimilarity(q, w) >= 0.5;
+            auto t1 = high_resolution_clock::now();
+            for (const auto &q : queries) {
+                BoundedEditDistance kernel(q);
+                for (const auto &w : words)
+                    boundedHits += kernel.within(w, std::max(q.size(), w.size()) / 2);
+            }
+            auto t2 = high_resolution_clock::now();
+
+            double pairs = static_cast<double>(QUERIES) * WORDS;
+            double fullNs = duration_cast<nanoseconds>(t1 - t0).count() / pairs;
+            double boundedNs = duration_cast<nanoseconds>(t2 - t1).count() / pairs;
+            std::cout << std::setw(12) << (std::to_string(range.first) + "-" + std::to_string(range.second))
+                      << std::fixed << std::setprecision(1)
+                      << std::setw(14) << fullNs << std::setw(14) << boundedNs
+                      << std::setw(9) << fullNs / boundedNs << "x"
+                      << (fullHits == boundedHits ? "" : "   MISMATCH") << "\n";
+        }
+
+        // End to end: fuzzy multi-word queries against the model
+        std::vector<std::string> vocabulary;
+        for (int i = 0; i < 5000; i++) vocabulary.push_back(word(3, 10));
+        for (int size : {10000, 100000}) {
+            auto model = std::make_unique<Model>();
+            auto base = system_clock::now();
+            for (int i = 0; i < size; i++) {
+                std::string title, description;
+                for (int k = 0; k < 3; k++) title += vocabulary[rng() % vocabulary.size()] + " ";
+                for (int k = 0; k < 8; k++) description += vocabulary[rng() % vocabulary.size()] + " ";
+                model->addEvent(Event("search_" + std::to_string(i), description, title, base + minutes(i), minutes(30)));
+            }
+            const int QUERIES = 100;
+            size_t hits = 0;
+            auto t0 = high_resolution_clock::now();
+            for (int q = 0; q < QUERIES; q++) {
+                std::string query = vocabulary[rng() % vocabulary.size()];
+                query[rng() % query.size()] = 'x';
+                hits += model->searchEvents(query + " " + vocabulary[rng() % vocabulary.size()].substr(0, 3)).size();
+            }
+            auto t1 = high_resolution_clock::now();
+            std::cout << "searchEvents @" << size << " events: " << std::fixed << std::setprecision(3)
+                      << duration_cast<microseconds>(t1 - t0).count() / 1000.0 / QUERIES << " ms/query ("
+                      << hits << " hits)\n";
+        }
+    }
+
     // API Performance Tests
     void runApiBenchmarks() {
         std::cout << "\n🌐 API BENCHMARKS\n";
@@ -392,6 +756,12 @@ public:
         curl_global_init(CURL_GLOBAL_DEFAULT);
         
         runModelBenchmarks();
+        runIndexBenchmarks();
+        runContentionBenchmarks();
+        runPersistenceBenchmarks();
+        runRecurrenceBenchmarks();
+        runLayoutBenchmarks();
+        runSearchBenchmarks();
         runApiBenchmarks();
         runFullSystemBenchmark();
         
@@ -414,6 +784,12 @@ int main(int argc, char* argv[]) {
             std::cout << "Usage: " << argv[0] << " [option]\n";
             std::cout << "Options:\n";
             std::cout << "  --model     Run model benchmarks only\n";
+            std::cout << "  --index     Run ID index scaling benchmarks only\n";
+            std::cout << "  --contention Run read latency under concurrent writes only\n";
+            std::cout << "  --persistence Run SQLite write throughput benchmarks only\n";
+            std::cout << "  --recurrence Run recurrence expansion benchmarks only\n";
+            std::cout << "  --layout    Run event store scan/memory benchmarks only\n";
+            std::cout << "  --search    Run search similarity and query benchmarks only\n";
             std::cout << "  --api       Run API benchmarks only\n";
             std::cout << "  --full      Run full system benchmark only\n";
             std::cout << "  --help      Show this help\n";
@@ -428,6 +804,18 @@ int main(int argc, char* argv[]) {
         std::string arg = argv[1];
         if (arg == "--model") {
             benchmark.runModelBenchmarks();
+        } else if (arg == "--index") {
+            benchmark.runIndexBenchmarks();
+        } else if (arg == "--contention") {
+            benchmark.runContentionBenchmarks();
+        } else if (arg == "--persistence") {
+            benchmark.runPersistenceBenchmarks();
+        } else if (arg == "--recurrence") {
+            benchmark.runRecurrenceBenchmarks();
+        } else if (arg == "--layout") {
+            benchmark.runLayoutBenchmarks();
+        } else if (arg == "--search") {
+            benchmark.runSearchBenchmarks();
         } else if (arg == "--api") {
             benchmark.runApiBenchmarks();
         } else if (arg == "--full") {
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "../model/Event.h"
+#include <exception>
+#include <utility>
+#include <vector>
 
 struct ProviderIds {
     std::string eventId; // calendar event id
@@ -20,4 +23,54 @@ public:
 
     // Delete an event from the calendar
     virtual void deleteEvent(const Event &event) = 0;
+
+    // Batch forms used by the model's bulk operations; results line up with
+    // the input. The defaults call the single-event methods, and a failure
+    // on one event leaves empty IDs for it without stopping the rest.
+    // Providers with a batch endpoint should override them.
+    virtual std::vector<ProviderIds> addEvents(const std::vector<const Event *> &events)
+    {
+        std::vector<ProviderIds> ids(events.size());
+        for (size_t i = 0; i < events.size(); ++i)
+        {
+            try
+            {
+                ids[i] = addEvent(*events[i]);
+            }
+            catch (const std::exception &)
+            {
+            }
+        }
+        return ids;
+    }
+
+    virtual std::vector<ProviderIds> updateEvents(const std::vector<std::pair<const Event *, const Event *>> &changes)
+    {
+        std::vector<ProviderIds> ids(changes.size());
+        for (size_t i = 0; i < changes.size(); ++i)
+        {
+            try
+            {
+                ids[i] = updateEvent(*changes[i].first, *changes[i].second);
+            }
+            catch (const std::exception &)
+            {
+            }
+        }
+        return ids;
+    }
+
+    virtual void deleteEvents(const std::vector<const Event *> &events)
+    {
+        for (const auto *e : events)
+        {
+            try
+            {
+                deleteEvent(*e);
+            }
+            catch (const std::exception &)
+            {
+            }
+        }
+    }
 };
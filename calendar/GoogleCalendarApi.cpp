@@ -9,6 +9,7 @@
 #include "../model/recurrence/MonthlyRecurrence.h"
 #include "../model/recurrence/WeeklyRecurrence.h"
 #include "../model/recurrence/YearlyRecurrence.h"
+#include "../model/recurrence/RRuleRecurrence.h"
 #include "../model/RecurringEvent.h"
 #include "nlohmann/json.hpp"
 
@@ -162,6 +163,16 @@ std::string GoogleCalendarApi::convertRecurrence(const Event &event) const
         return "";
 
     auto pat = recEv->getRecurrencePattern();
+    // One recurrence line per row; the script splits them into the list
+    if (auto rr = dynamic_cast<const RRuleRecurrence *>(pat.get()))
+    {
+        std::string lines = rr->rruleLine();
+        auto exdates = rr->getExdates();
+        for (size_t i = 0; i < exdates.size(); ++i)
+            lines += (i ? "," : "\nEXDATE:") + formatRFC5545UTC(exdates[i]);
+        return lines;
+    }
+
     std::ostringstream rrule;
 
     std::string type = pat->type();
@@ -103,10 +103,10 @@ def main():
                     :64
                 ]  # Google Calendar ID constraints
 
-            # Add recurrence if provided
+            # Add recurrence if provided: RRULE and EXDATE lines, one per row
             recurrence = os.environ.get("GCAL_RECURRENCE")
             if recurrence:
-                event["recurrence"] = [recurrence]
+                event["recurrence"] = [line.strip() for line in recurrence.splitlines() if line.strip()]
 
             # Create the event
             created_event = cal_service.events().insert(calendarId=calendar_id, body=event).execute()
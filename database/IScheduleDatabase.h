@@ -1,8 +1,12 @@
 #pragma once
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <memory>
+#include <utility>
 #include "../model/Event.h"
 
 class IScheduleDatabase {
@@ -13,4 +17,156 @@ public:
     virtual bool removeEvent(const std::string &id) = 0;
     virtual bool removeAllEvents() = 0;
     virtual std::vector<std::unique_ptr<Event>> getAllEvents() const = 0;
+
+    // Paged reads for a model that keeps only a time window resident. The
+    // defaults filter getAllEvents(); stores that can answer them from an
+    // index should override them.
+
+    // One-time events starting in [start, end), in time order; at most
+    // `limit` of them when limit > 0.
+    virtual std::vector<std::unique_ptr<Event>> getEventsInRange(std::chrono::system_clock::time_point start,
+                                                                 std::chrono::system_clock::time_point end,
+                                                                 size_t limit) const
+    {
+        std::vector<std::unique_ptr<Event>> result;
+        for (auto &e : getAllEvents())
+        {
+            if (e->isRecurring() || e->getTime() < start || !(e->getTime() < end))
+                continue;
+            result.push_back(std::move(e));
+        }
+        std::stable_sort(result.begin(), result.end(), [](const auto &a, const auto &b)
+                         { return a->getTime() < b->getTime(); });
+        if (limit > 0 && result.size() > limit)
+            result.resize(limit);
+        return result;
+    }
+
+    // How many one-time events start in [start, end), without reading them.
+    virtual size_t countEventsInRange(std::chrono::system_clock::time_point start,
+                                      std::chrono::system_clock::time_point end) const
+    {
+        return getEventsInRange(start, end, 0).size();
+    }
+
+    // Every recurring series, whatever its start.
+    virtual std::vector<std::unique_ptr<Event>> getRecurringEvents() const
+    {
+        auto result = getAllEvents();
+        result.erase(std::remove_if(result.begin(), result.end(), [](const auto &e)
+                                    { return !e->isRecurring(); }),
+                     result.end());
+        return result;
+    }
+
+    // The stored event with this ID, or null.
+    virtual std::unique_ptr<Event> getEventById(const std::string &id) const
+    {
+        for (auto &e : getAllEvents())
+        {
+            if (e->getId() == id)
+                return std::move(e);
+        }
+        return nullptr;
+    }
+
+    // Longest duration of any stored one-time event (zero when there are none).
+    virtual std::chrono::seconds getLongestDuration() const
+    {
+        std::chrono::seconds longest{0};
+        for (const auto &e : getAllEvents())
+        {
+            if (!e->isRecurring())
+                longest = std::max(longest, std::chrono::duration_cast<std::chrono::seconds>(e->getDuration()));
+        }
+        return longest;
+    }
+
+    // Soft-delete tombstones: deleted events set aside until they are
+    // restored or purged. Stores that return false from storesTombstones()
+    // leave keeping them to the caller.
+    virtual bool storesTombstones() const { return false; }
+    virtual bool addTombstone(const Event &, std::chrono::system_clock::time_point /*deletedAt*/) { return false; }
+    virtual bool removeTombstone(const std::string &) { return false; }
+    // Drop tombstones deleted before `cutoff`.
+    virtual bool purgeTombstones(std::chrono::system_clock::time_point /*cutoff*/) { return false; }
+    virtual std::unique_ptr<Event> getTombstone(const std::string &) const { return nullptr; }
+    // Deleted events in event-time order, skipping `offset`; at most `limit`
+    // of them when limit > 0.
+    virtual std::vector<std::unique_ptr<Event>> getTombstones(size_t /*offset*/, size_t /*limit*/) const { return {}; }
+    // ID and deletion time of every tombstone, oldest deletion first.
+    virtual std::vector<std::pair<std::string, std::chrono::system_clock::time_point>> getTombstoneIds() const { return {}; }
+
+    // One row write in a batch: insert or replace `event`, or delete the
+    // row with `id` when event is null. With fewer than all `fields`
+    // (Event::Field bits) only those columns of the existing row change.
+    struct EventWrite
+    {
+        std::string id;
+        const Event *event = nullptr;
+        uint16_t fields = Event::kAllFields;
+    };
+
+    // Write back only the `fields` (Event::Field bits) of the stored row
+    // with e's ID; all of them means the whole row, recurrence included.
+    // The default always rewrites the whole row.
+    virtual bool updateFields(const Event &e, uint16_t fields)
+    {
+        if ((fields & Event::kAllFields) == 0)
+            return true;
+        removeEvent(e.getId());
+        return addEvent(e);
+    }
+
+    // Apply `writes` in order as one commit. False if any write fails, in
+    // which case a store with transactions applies none of them. The default brackets the single-row calls in a
+    // transaction; stores that can reuse one prepared statement across rows
+    // should override it.
+    virtual bool writeEvents(const std::vector<EventWrite> &writes)
+    {
+        bool inTransaction = beginTransaction();
+        bool ok = true;
+        for (const auto &w : writes)
+        {
+            if (!w.event)
+                ok = removeEvent(w.id);
+            else if ((w.fields & Event::kAllFields) == Event::kAllFields)
+                ok = addEvent(*w.event);
+            else
+                ok = updateFields(*w.event, w.fields);
+            if (!ok)
+                break;
+        }
+        if (inTransaction && (!ok || !commitTransaction()))
+        {
+            rollbackTransaction();
+            return false;
+        }
+        return ok;
+    }
+
+    // Delete every event (one-time or series) starting in [start, end).
+    // The default deletes the matching rows one by one in one batch.
+    virtual bool removeEventsInRange(std::chrono::system_clock::time_point start,
+                                     std::chrono::system_clock::time_point end)
+    {
+        std::vector<EventWrite> writes;
+        for (const auto &e : getAllEvents())
+        {
+            if (!(e->getTime() < start) && e->getTime() < end)
+                writes.push_back({e->getId(), nullptr});
+        }
+        return writeEvents(writes);
+    }
+
+    // Optional transaction bracket so a batch of writes commits once.
+    // Stores without transactions can keep these no-ops.
+    virtual bool beginTransaction() { return true; }
+    virtual bool commitTransaction() { return true; }
+    virtual bool rollbackTransaction() { return true; }
+
+    // Block until every write issued so far is durable. False when a write
+    // that was acknowledged could not be stored. Synchronous stores report
+    // failures as they happen, so the default does nothing.
+    virtual bool flush() { return true; }
 };
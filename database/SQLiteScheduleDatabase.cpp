@@ -5,8 +5,11 @@
 #include "../model/recurrence/WeeklyRecurrence.h"
 #include "../model/recurrence/MonthlyRecurrence.h"
 #include "../model/recurrence/YearlyRecurrence.h"
+#include "../model/recurrence/RRuleRecurrence.h"
 #include "../utils/WeekDay.h"
+#include "../utils/InternPool.h"
 #include "nlohmann/json.hpp"
+#include <map>
 #include <stdexcept>
 
 SQLiteScheduleDatabase::SQLiteScheduleDatabase(const std::string &path)
@@ -140,6 +143,38 @@ SQLiteScheduleDatabase::SQLiteScheduleDatabase(const std::string &path)
             if (errMsg) sqlite3_free(errMsg);
         }
     }
+
+    // Soft-deleted events, kept until restored or past their retention
+    if (sqlite3_exec(db_.get(),
+                     "CREATE TABLE IF NOT EXISTS deleted_events ("
+                     "id TEXT PRIMARY KEY,"
+                     "description TEXT,"
+                     "title TEXT,"
+                     "time INTEGER,"
+                     "duration INTEGER,"
+                     "recurrence TEXT,"
+                     "category TEXT,"
+                     "notifier TEXT,"
+                     "action TEXT,"
+                     "google_event_id TEXT,"
+                     "google_task_id TEXT,"
+                     "deleted_at INTEGER);"
+                     "CREATE INDEX IF NOT EXISTS idx_deleted_events_deleted_at ON deleted_events(deleted_at);",
+                     nullptr, nullptr, &errMsg) != SQLITE_OK)
+    {
+        std::string msg = errMsg ? errMsg : "error creating tombstone table";
+        sqlite3_free(errMsg);
+        throw std::runtime_error(msg);
+    }
+
+    // Range loads seek on time instead of scanning the table
+    if (sqlite3_exec(db_.get(), "CREATE INDEX IF NOT EXISTS idx_events_time ON events(time);",
+                     nullptr, nullptr, &errMsg) != SQLITE_OK)
+    {
+        std::string msg = errMsg ? errMsg : "error creating time index";
+        sqlite3_free(errMsg);
+        throw std::runtime_error(msg);
+    }
 }
 
 bool SQLiteScheduleDatabase::addEvent(const Event &e)
@@ -150,7 +185,169 @@ bool SQLiteScheduleDatabase::addEvent(const Event &e)
     sqlite3_stmt *stmt = nullptr;
     if (sqlite3_prepare_v2(db_.get(), sql, -1, &stmt, nullptr) != SQLITE_OK)
         return false;
+    bindEvent(stmt, e);
+    bool ok = sqlite3_step(stmt) == SQLITE_DONE;
+    sqlite3_finalize(stmt);
+    return ok;
+}
+
+bool SQLiteScheduleDatabase::writeEvents(const std::vector<EventWrite> &writes)
+{
+    if (writes.empty())
+        return true;
+    const char *insertSql =
+        "INSERT OR REPLACE INTO events (id, description, title, time, duration, recurrence, category, notifier, action, google_event_id, google_task_id) "
+        "VALUES (?,?,?,?,?,?,?,?,?,?,?);";
+    const char *deleteSql = "DELETE FROM events WHERE id = ?;";
+    sqlite3_stmt *insert = nullptr;
+    sqlite3_stmt *remove = nullptr;
+    if (sqlite3_prepare_v2(db_.get(), insertSql, -1, &insert, nullptr) != SQLITE_OK ||
+        sqlite3_prepare_v2(db_.get(), deleteSql, -1, &remove, nullptr) != SQLITE_OK)
+    {
+        sqlite3_finalize(insert);
+        sqlite3_finalize(remove);
+        return false;
+    }
+
+    // Partial writes, one prepared UPDATE per distinct column set
+    std::map<uint16_t, sqlite3_stmt *> updates;
+
+    // Join a transaction the caller already opened rather than nesting one
+    bool ownTransaction = sqlite3_get_autocommit(db_.get()) != 0 && beginTransaction();
+    bool ok = true;
+    for (const auto &w : writes)
+    {
+        sqlite3_stmt *stmt = nullptr;
+        const uint16_t fields = w.fields & Event::kAllFields;
+        if (!w.event)
+        {
+            stmt = remove;
+            sqlite3_bind_text(stmt, 1, w.id.c_str(), -1, SQLITE_TRANSIENT);
+        }
+        else if (fields == Event::kAllFields)
+        {
+            stmt = insert;
+            bindEvent(stmt, *w.event);
+        }
+        else if (fields != 0)
+        {
+            auto &cached = updates[fields];
+            if (!cached)
+                cached = prepareUpdate(fields);
+            stmt = cached;
+            if (!stmt)
+            {
+                ok = false;
+                break;
+            }
+            bindFields(stmt, *w.event, fields);
+        }
+        if (!stmt)
+            continue;
+        ok = sqlite3_step(stmt) == SQLITE_DONE;
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+        if (!ok)
+            break;
+    }
+    sqlite3_finalize(insert);
+    sqlite3_finalize(remove);
+    for (auto &entry : updates)
+        sqlite3_finalize(entry.second);
+
+    // All or nothing: a failed row undoes the rows before it. In a caller's
+    // transaction the caller rolls back on the false result.
+    if (ownTransaction && (!ok || !commitTransaction()))
+    {
+        rollbackTransaction();
+        return false;
+    }
+    return ok;
+}
+
+bool SQLiteScheduleDatabase::updateFields(const Event &e, uint16_t fields)
+{
+    fields &= Event::kAllFields;
+    if (fields == 0)
+        return true;
+    if (fields == Event::kAllFields)
+        return addEvent(e);
+    sqlite3_stmt *stmt = prepareUpdate(fields);
+    if (!stmt)
+        return false;
+    bindFields(stmt, e, fields);
+    bool ok = sqlite3_step(stmt) == SQLITE_DONE;
+    sqlite3_finalize(stmt);
+    return ok;
+}
+
+namespace
+{
+    // Column behind each Event::Field bit, lowest bit first
+    const char *const kFieldColumns[] = {"description", "title", "time", "duration", "category",
+                                         "google_event_id", "google_task_id", "notifier", "action"};
+
+    // Optional text columns store NULL rather than ''
+    void bindOptionalText(sqlite3_stmt *stmt, int index, const std::string &value)
+    {
+        if (value.empty())
+            sqlite3_bind_null(stmt, index);
+        else
+            sqlite3_bind_text(stmt, index, value.c_str(), -1, SQLITE_TRANSIENT);
+    }
+} // namespace
+
+sqlite3_stmt *SQLiteScheduleDatabase::prepareUpdate(uint16_t fields) const
+{
+    std::string sql = "UPDATE events SET ";
+    bool first = true;
+    for (size_t bit = 0; bit < sizeof(kFieldColumns) / sizeof(kFieldColumns[0]); ++bit)
+    {
+        if (!(fields & (1u << bit)))
+            continue;
+        if (!first)
+            sql += ", ";
+        sql += kFieldColumns[bit];
+        sql += " = ?";
+        first = false;
+    }
+    sql += " WHERE id = ?;";
+    sqlite3_stmt *stmt = nullptr;
+    if (sqlite3_prepare_v2(db_.get(), sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+    {
+        sqlite3_finalize(stmt);
+        return nullptr;
+    }
+    return stmt;
+}
 
+void SQLiteScheduleDatabase::bindFields(sqlite3_stmt *stmt, const Event &e, uint16_t fields) const
+{
+    // Same encodings as bindEvent, in the column order prepareUpdate used
+    int index = 1;
+    if (fields & Event::kDescription)
+        sqlite3_bind_text(stmt, index++, e.getDescription().c_str(), -1, SQLITE_TRANSIENT);
+    if (fields & Event::kTitle)
+        sqlite3_bind_text(stmt, index++, e.getTitle().c_str(), -1, SQLITE_TRANSIENT);
+    if (fields & Event::kTime)
+        sqlite3_bind_int64(stmt, index++, std::chrono::duration_cast<std::chrono::seconds>(e.getTime().time_since_epoch()).count());
+    if (fields & Event::kDuration)
+        sqlite3_bind_int64(stmt, index++, std::chrono::duration_cast<std::chrono::seconds>(e.getDuration()).count());
+    if (fields & Event::kCategory)
+        bindOptionalText(stmt, index++, e.getCategory());
+    if (fields & Event::kProviderEventId)
+        bindOptionalText(stmt, index++, e.getProviderEventId());
+    if (fields & Event::kProviderTaskId)
+        bindOptionalText(stmt, index++, e.getProviderTaskId());
+    if (fields & Event::kNotifier)
+        bindOptionalText(stmt, index++, e.getNotifierName());
+    if (fields & Event::kAction)
+        bindOptionalText(stmt, index++, e.getActionName());
+    sqlite3_bind_text(stmt, index, e.getId().c_str(), -1, SQLITE_TRANSIENT);
+}
+
+void SQLiteScheduleDatabase::bindEvent(sqlite3_stmt *stmt, const Event &e) const
+{
     sqlite3_bind_text(stmt, 1, e.getId().c_str(), -1, SQLITE_TRANSIENT);
     sqlite3_bind_text(stmt, 2, e.getDescription().c_str(), -1, SQLITE_TRANSIENT);
     sqlite3_bind_text(stmt, 3, e.getTitle().c_str(), -1, SQLITE_TRANSIENT);
@@ -205,6 +402,15 @@ bool SQLiteScheduleDatabase::addEvent(const Event &e)
                 auto endSec = std::chrono::duration_cast<std::chrono::seconds>(yr->getEndDate().time_since_epoch()).count();
                 j["end"] = endSec;
             }
+            else if (auto rr = dynamic_cast<RRuleRecurrence *>(pat.get()))
+            {
+                j["type"] = "rrule";
+                j["rule"] = rr->getRule();
+                std::vector<long long> exdates;
+                for (auto t : rr->getExdates())
+                    exdates.push_back(std::chrono::duration_cast<std::chrono::seconds>(t.time_since_epoch()).count());
+                j["exdates"] = exdates;
+            }
             recJson = j.dump();
         }
     }
@@ -238,10 +444,6 @@ bool SQLiteScheduleDatabase::addEvent(const Event &e)
     const std::string &gtaskId = e.getProviderTaskId();
     if (gtaskId.empty()) sqlite3_bind_null(stmt, 11);
     else sqlite3_bind_text(stmt, 11, gtaskId.c_str(), -1, SQLITE_TRANSIENT);
-
-    bool ok = sqlite3_step(stmt) == SQLITE_DONE;
-    sqlite3_finalize(stmt);
-    return ok;
 }
 
 bool SQLiteScheduleDatabase::removeEvent(const std::string &id)
@@ -256,6 +458,34 @@ bool SQLiteScheduleDatabase::removeEvent(const std::string &id)
     return ok;
 }
 
+bool SQLiteScheduleDatabase::exec(const char *sql)
+{
+    char *errMsg = nullptr;
+    if (sqlite3_exec(db_.get(), sql, nullptr, nullptr, &errMsg) != SQLITE_OK)
+    {
+        if (errMsg)
+            sqlite3_free(errMsg);
+        return false;
+    }
+    return true;
+}
+
+bool SQLiteScheduleDatabase::beginTransaction()
+{
+    // IMMEDIATE takes the write lock up front so the batch can't deadlock midway
+    return exec("BEGIN IMMEDIATE;");
+}
+
+bool SQLiteScheduleDatabase::commitTransaction()
+{
+    return exec("COMMIT;");
+}
+
+bool SQLiteScheduleDatabase::rollbackTransaction()
+{
+    return exec("ROLLBACK;");
+}
+
 bool SQLiteScheduleDatabase::removeAllEvents()
 {
     const char *sql = "DELETE FROM events;";
@@ -269,19 +499,210 @@ bool SQLiteScheduleDatabase::removeAllEvents()
     return true;
 }
 
+namespace
+{
+    const char *const kEventColumns =
+        "SELECT id, description, title, time, duration, recurrence, category, notifier, action, google_event_id, google_task_id FROM events ";
+    const char *const kTombstoneColumns =
+        "SELECT id, description, title, time, duration, recurrence, category, notifier, action, google_event_id, google_task_id FROM deleted_events ";
+
+    long long toSeconds(std::chrono::system_clock::time_point tp)
+    {
+        return std::chrono::duration_cast<std::chrono::seconds>(tp.time_since_epoch()).count();
+    }
+
+    // Stored times are whole seconds, so a row is at or after `tp` exactly
+    // when its time is at or after tp rounded up.
+    long long ceilSeconds(std::chrono::system_clock::time_point tp)
+    {
+        return std::chrono::ceil<std::chrono::seconds>(tp).time_since_epoch().count();
+    }
+} // namespace
+
 std::vector<std::unique_ptr<Event>> SQLiteScheduleDatabase::getAllEvents() const
+{
+    std::string sql = std::string(kEventColumns) + "ORDER BY time;";
+    sqlite3_stmt *stmt = nullptr;
+    if (sqlite3_prepare_v2(db_.get(), sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+        return {};
+    return readEvents(stmt);
+}
+
+std::vector<std::unique_ptr<Event>> SQLiteScheduleDatabase::getEventsInRange(std::chrono::system_clock::time_point start,
+                                                                             std::chrono::system_clock::time_point end,
+                                                                             size_t limit) const
+{
+    std::string sql = std::string(kEventColumns) +
+                      "WHERE recurrence IS NULL AND time >= ? AND time < ? ORDER BY time LIMIT ?;";
+    sqlite3_stmt *stmt = nullptr;
+    if (sqlite3_prepare_v2(db_.get(), sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+        return {};
+    sqlite3_bind_int64(stmt, 1, ceilSeconds(start));
+    sqlite3_bind_int64(stmt, 2, ceilSeconds(end));
+    // A negative LIMIT means no limit
+    sqlite3_bind_int64(stmt, 3, limit > 0 ? static_cast<long long>(limit) : -1);
+    return readEvents(stmt);
+}
+
+size_t SQLiteScheduleDatabase::countEventsInRange(std::chrono::system_clock::time_point start,
+                                                  std::chrono::system_clock::time_point end) const
+{
+    const char *sql = "SELECT COUNT(*) FROM events WHERE recurrence IS NULL AND time >= ? AND time < ?;";
+    sqlite3_stmt *stmt = nullptr;
+    if (sqlite3_prepare_v2(db_.get(), sql, -1, &stmt, nullptr) != SQLITE_OK)
+        return 0;
+    sqlite3_bind_int64(stmt, 1, ceilSeconds(start));
+    sqlite3_bind_int64(stmt, 2, ceilSeconds(end));
+    size_t count = sqlite3_step(stmt) == SQLITE_ROW ? static_cast<size_t>(sqlite3_column_int64(stmt, 0)) : 0;
+    sqlite3_finalize(stmt);
+    return count;
+}
+
+bool SQLiteScheduleDatabase::removeEventsInRange(std::chrono::system_clock::time_point start,
+                                                 std::chrono::system_clock::time_point end)
+{
+    // One statement is one transaction, and idx_events_time finds the rows
+    const char *sql = "DELETE FROM events WHERE time >= ? AND time < ?;";
+    sqlite3_stmt *stmt = nullptr;
+    if (sqlite3_prepare_v2(db_.get(), sql, -1, &stmt, nullptr) != SQLITE_OK)
+        return false;
+    sqlite3_bind_int64(stmt, 1, ceilSeconds(start));
+    sqlite3_bind_int64(stmt, 2, ceilSeconds(end));
+    bool ok = sqlite3_step(stmt) == SQLITE_DONE;
+    sqlite3_finalize(stmt);
+    return ok;
+}
+
+std::vector<std::unique_ptr<Event>> SQLiteScheduleDatabase::getRecurringEvents() const
+{
+    std::string sql = std::string(kEventColumns) + "WHERE recurrence IS NOT NULL ORDER BY time;";
+    sqlite3_stmt *stmt = nullptr;
+    if (sqlite3_prepare_v2(db_.get(), sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+        return {};
+    return readEvents(stmt);
+}
+
+std::unique_ptr<Event> SQLiteScheduleDatabase::getEventById(const std::string &id) const
+{
+    std::string sql = std::string(kEventColumns) + "WHERE id = ?;";
+    sqlite3_stmt *stmt = nullptr;
+    if (sqlite3_prepare_v2(db_.get(), sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+        return nullptr;
+    sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_TRANSIENT);
+    auto rows = readEvents(stmt);
+    if (rows.empty())
+        return nullptr;
+    return std::move(rows.front());
+}
+
+std::chrono::seconds SQLiteScheduleDatabase::getLongestDuration() const
+{
+    const char *sql = "SELECT MAX(duration) FROM events WHERE recurrence IS NULL;";
+    sqlite3_stmt *stmt = nullptr;
+    if (sqlite3_prepare_v2(db_.get(), sql, -1, &stmt, nullptr) != SQLITE_OK)
+        return std::chrono::seconds(0);
+    long long longest = 0;
+    if (sqlite3_step(stmt) == SQLITE_ROW)
+        longest = sqlite3_column_int64(stmt, 0); // NULL on an empty table reads as 0
+    sqlite3_finalize(stmt);
+    return std::chrono::seconds(longest);
+}
+
+bool SQLiteScheduleDatabase::addTombstone(const Event &e, std::chrono::system_clock::time_point deletedAt)
 {
     const char *sql =
-        "SELECT id, description, title, time, duration, recurrence, category, notifier, action, google_event_id, google_task_id FROM events ORDER BY time;";
+        "INSERT OR REPLACE INTO deleted_events (id, description, title, time, duration, recurrence, category, notifier, action, google_event_id, google_task_id, deleted_at) "
+        "VALUES (?,?,?,?,?,?,?,?,?,?,?,?);";
     sqlite3_stmt *stmt = nullptr;
     if (sqlite3_prepare_v2(db_.get(), sql, -1, &stmt, nullptr) != SQLITE_OK)
+        return false;
+    bindEvent(stmt, e);
+    sqlite3_bind_int64(stmt, 12, toSeconds(deletedAt));
+    bool ok = sqlite3_step(stmt) == SQLITE_DONE;
+    sqlite3_finalize(stmt);
+    return ok;
+}
+
+bool SQLiteScheduleDatabase::removeTombstone(const std::string &id)
+{
+    const char *sql = "DELETE FROM deleted_events WHERE id = ?;";
+    sqlite3_stmt *stmt = nullptr;
+    if (sqlite3_prepare_v2(db_.get(), sql, -1, &stmt, nullptr) != SQLITE_OK)
+        return false;
+    sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_TRANSIENT);
+    bool ok = sqlite3_step(stmt) == SQLITE_DONE;
+    sqlite3_finalize(stmt);
+    return ok;
+}
+
+bool SQLiteScheduleDatabase::purgeTombstones(std::chrono::system_clock::time_point cutoff)
+{
+    const char *sql = "DELETE FROM deleted_events WHERE deleted_at < ?;";
+    sqlite3_stmt *stmt = nullptr;
+    if (sqlite3_prepare_v2(db_.get(), sql, -1, &stmt, nullptr) != SQLITE_OK)
+        return false;
+    sqlite3_bind_int64(stmt, 1, ceilSeconds(cutoff));
+    bool ok = sqlite3_step(stmt) == SQLITE_DONE;
+    sqlite3_finalize(stmt);
+    return ok;
+}
+
+std::unique_ptr<Event> SQLiteScheduleDatabase::getTombstone(const std::string &id) const
+{
+    std::string sql = std::string(kTombstoneColumns) + "WHERE id = ?;";
+    sqlite3_stmt *stmt = nullptr;
+    if (sqlite3_prepare_v2(db_.get(), sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+        return nullptr;
+    sqlite3_bind_text(stmt, 1, id.c_str(), -1, SQLITE_TRANSIENT);
+    auto rows = readEvents(stmt);
+    if (rows.empty())
+        return nullptr;
+    return std::move(rows.front());
+}
+
+std::vector<std::unique_ptr<Event>> SQLiteScheduleDatabase::getTombstones(size_t offset, size_t limit) const
+{
+    std::string sql = std::string(kTombstoneColumns) + "ORDER BY time, id LIMIT ? OFFSET ?;";
+    sqlite3_stmt *stmt = nullptr;
+    if (sqlite3_prepare_v2(db_.get(), sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
         return {};
+    sqlite3_bind_int64(stmt, 1, limit > 0 ? static_cast<long long>(limit) : -1);
+    sqlite3_bind_int64(stmt, 2, static_cast<long long>(offset));
+    return readEvents(stmt);
+}
 
+std::vector<std::pair<std::string, std::chrono::system_clock::time_point>> SQLiteScheduleDatabase::getTombstoneIds() const
+{
+    const char *sql = "SELECT id, deleted_at FROM deleted_events ORDER BY deleted_at;";
+    sqlite3_stmt *stmt = nullptr;
+    if (sqlite3_prepare_v2(db_.get(), sql, -1, &stmt, nullptr) != SQLITE_OK)
+        return {};
+    std::vector<std::pair<std::string, std::chrono::system_clock::time_point>> result;
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+        const unsigned char *id = sqlite3_column_text(stmt, 0);
+        result.emplace_back(id ? reinterpret_cast<const char *>(id) : std::string(),
+                            std::chrono::system_clock::time_point(std::chrono::seconds(sqlite3_column_int64(stmt, 1))));
+    }
+    sqlite3_finalize(stmt);
+    return result;
+}
+
+std::vector<std::unique_ptr<Event>> SQLiteScheduleDatabase::readEvents(sqlite3_stmt *stmt) const
+{
     std::vector<std::unique_ptr<Event>> result;
     auto safeText = [](sqlite3_stmt* s, int col)->std::string {
         const unsigned char *t = sqlite3_column_text(s, col);
         return t ? reinterpret_cast<const char *>(t) : std::string();
     };
+    // Repeated names go straight into the pool without a temporary string
+    auto internText = [](sqlite3_stmt* s, int col)->InternPool::Handle {
+        const unsigned char *t = sqlite3_column_text(s, col);
+        if (!t)
+            return InternPool::kEmpty;
+        return InternPool::intern(std::string_view(reinterpret_cast<const char *>(t),
+                                                   static_cast<size_t>(sqlite3_column_bytes(s, col))));
+    };
     while (sqlite3_step(stmt) == SQLITE_ROW)
     {
         std::string id = safeText(stmt, 0);
@@ -290,9 +711,9 @@ std::vector<std::unique_ptr<Event>> SQLiteScheduleDatabase::getAllEvents() const
         long long timeSec = sqlite3_column_int64(stmt, 3);
         long long durSec = sqlite3_column_int64(stmt, 4);
         const unsigned char *recText = sqlite3_column_text(stmt, 5);
-        std::string category = safeText(stmt, 6);
-        std::string notifier = safeText(stmt, 7);
-        std::string action = safeText(stmt, 8);
+        InternPool::Handle category = internText(stmt, 6);
+        InternPool::Handle notifier = internText(stmt, 7);
+        InternPool::Handle action = internText(stmt, 8);
         std::string provEvent = safeText(stmt, 9);
         std::string provTask = safeText(stmt, 10);
         auto tp = std::chrono::system_clock::time_point(std::chrono::seconds(timeSec));
@@ -341,12 +762,20 @@ std::vector<std::unique_ptr<Event>> SQLiteScheduleDatabase::getAllEvents() const
                     auto endTp = std::chrono::system_clock::time_point(std::chrono::seconds(endSec));
                     pat = std::make_shared<YearlyRecurrence>(tp, interval, max, endTp);
                 }
+                else if (type == "rrule")
+                {
+                    std::vector<std::chrono::system_clock::time_point> exdates;
+                    for (long long sec : j.value("exdates", std::vector<long long>{}))
+                        exdates.push_back(std::chrono::system_clock::time_point(std::chrono::seconds(sec)));
+                    pat = std::make_shared<RRuleRecurrence>(tp, j.value("rule", ""), exdates);
+                }
 
                 if (pat)
                 {
-                    auto ev = std::make_unique<RecurringEvent>(id, desc, title, tp, dur, pat, category);
-                    if (!notifier.empty()) ev->setNotifierName(notifier);
-                    if (!action.empty()) ev->setActionName(action);
+                    auto ev = std::make_unique<RecurringEvent>(id, desc, title, tp, dur, pat);
+                    ev->setCategoryHandle(category);
+                    ev->setNotifierHandle(notifier);
+                    ev->setActionHandle(action);
                     if (!provEvent.empty()) ev->setProviderEventId(provEvent);
                     if (!provTask.empty()) ev->setProviderTaskId(provTask);
                     result.push_back(std::move(ev));
@@ -358,9 +787,10 @@ std::vector<std::unique_ptr<Event>> SQLiteScheduleDatabase::getAllEvents() const
                 // fall back to one-time event
             }
         }
-        auto ev = std::make_unique<OneTimeEvent>(id, desc, title, tp, dur, category);
-        if (!notifier.empty()) ev->setNotifierName(notifier);
-        if (!action.empty()) ev->setActionName(action);
+        auto ev = std::make_unique<OneTimeEvent>(id, desc, title, tp, dur);
+        ev->setCategoryHandle(category);
+        ev->setNotifierHandle(notifier);
+        ev->setActionHandle(action);
         if (!provEvent.empty()) ev->setProviderEventId(provEvent);
         if (!provTask.empty()) ev->setProviderTaskId(provTask);
         result.push_back(std::move(ev));
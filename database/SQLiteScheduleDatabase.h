@@ -14,7 +14,41 @@ public:
     bool removeEvent(const std::string &id) override;
     bool removeAllEvents() override;
     std::vector<std::unique_ptr<Event>> getAllEvents() const override;
+    std::vector<std::unique_ptr<Event>> getEventsInRange(std::chrono::system_clock::time_point start,
+                                                         std::chrono::system_clock::time_point end,
+                                                         size_t limit) const override;
+    size_t countEventsInRange(std::chrono::system_clock::time_point start,
+                              std::chrono::system_clock::time_point end) const override;
+    std::vector<std::unique_ptr<Event>> getRecurringEvents() const override;
+    std::unique_ptr<Event> getEventById(const std::string &id) const override;
+    std::chrono::seconds getLongestDuration() const override;
+    bool writeEvents(const std::vector<EventWrite> &writes) override;
+    bool updateFields(const Event &e, uint16_t fields) override;
+    bool removeEventsInRange(std::chrono::system_clock::time_point start,
+                             std::chrono::system_clock::time_point end) override;
+
+    bool storesTombstones() const override { return true; }
+    bool addTombstone(const Event &e, std::chrono::system_clock::time_point deletedAt) override;
+    bool removeTombstone(const std::string &id) override;
+    bool purgeTombstones(std::chrono::system_clock::time_point cutoff) override;
+    std::unique_ptr<Event> getTombstone(const std::string &id) const override;
+    std::vector<std::unique_ptr<Event>> getTombstones(size_t offset, size_t limit) const override;
+    std::vector<std::pair<std::string, std::chrono::system_clock::time_point>> getTombstoneIds() const override;
+
+    bool beginTransaction() override;
+    bool commitTransaction() override;
+    bool rollbackTransaction() override;
 
 private:
+    bool exec(const char *sql);
+    // Bind the eleven event columns, in table order, as parameters 1-11.
+    void bindEvent(sqlite3_stmt *stmt, const Event &e) const;
+    // UPDATE of the columns behind `fields` (Event::Field bits), keyed by
+    // id, and its bindings: the columns in bit order, then the id.
+    sqlite3_stmt *prepareUpdate(uint16_t fields) const;
+    void bindFields(sqlite3_stmt *stmt, const Event &e, uint16_t fields) const;
+    // Step a prepared SELECT of the event columns and finalize it.
+    std::vector<std::unique_ptr<Event>> readEvents(sqlite3_stmt *stmt) const;
+
     std::unique_ptr<sqlite3, decltype(&sqlite3_close)> db_;
 };
@@ -0,0 +1,416 @@
+#include "WriteBehindScheduleDatabase.h"
+#include "../utils/Logger.h"
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+// Tries per batch before its writes are given up on
+constexpr int kCommitAttempts = 3;
+}
+
+WriteBehindScheduleDatabase::WriteBehindScheduleDatabase(std::shared_ptr<IScheduleDatabase> inner,
+                                                         std::chrono::milliseconds flushInterval,
+                                                         size_t batchSize)
+    : inner_(std::move(inner)),
+      flushInterval_(flushInterval),
+      batchSize_(batchSize == 0 ? 1 : batchSize)
+{
+    if (!inner_)
+        throw std::invalid_argument("WriteBehindScheduleDatabase needs an inner database");
+    worker_ = std::thread(&WriteBehindScheduleDatabase::run, this);
+}
+
+WriteBehindScheduleDatabase::~WriteBehindScheduleDatabase()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    // The persister drains whatever is still queued before exiting
+    worker_.join();
+}
+
+bool WriteBehindScheduleDatabase::addEvent(const Event &e)
+{
+    enqueue({OpKind::Add, e.clone(), e.getId(), 0});
+    return true;
+}
+
+bool WriteBehindScheduleDatabase::removeEvent(const std::string &id)
+{
+    enqueue({OpKind::Remove, nullptr, id, 0});
+    return true;
+}
+
+bool WriteBehindScheduleDatabase::removeAllEvents()
+{
+    enqueue({OpKind::RemoveAll, nullptr, std::string(), 0});
+    return true;
+}
+
+bool WriteBehindScheduleDatabase::writeEvents(const std::vector<EventWrite> &writes)
+{
+    // Copy the rows before taking the lock; the queue is held only to append
+    std::vector<Op> ops;
+    ops.reserve(writes.size());
+    for (const auto &w : writes)
+    {
+        if (w.event && (w.fields & Event::kAllFields) == Event::kAllFields)
+            ops.push_back({OpKind::Add, w.event->clone(), w.event->getId(), 0});
+        else if (w.event)
+            ops.push_back({OpKind::Update, w.event->clone(), w.event->getId(), 0, {}, {}, w.fields});
+        else
+            ops.push_back({OpKind::Remove, nullptr, w.id, 0});
+    }
+    bool full = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (inTransaction_ && transactionOwner_ == std::this_thread::get_id())
+        {
+            for (auto &op : ops)
+                staged_.push_back(std::move(op));
+        }
+        else
+            full = pushLocked(std::move(ops));
+    }
+    if (full)
+        wake_.notify_one();
+    return true;
+}
+
+bool WriteBehindScheduleDatabase::updateFields(const Event &e, uint16_t fields)
+{
+    enqueue({OpKind::Update, e.clone(), e.getId(), 0, {}, {}, fields});
+    return true;
+}
+
+bool WriteBehindScheduleDatabase::removeEventsInRange(std::chrono::system_clock::time_point start,
+                                                      std::chrono::system_clock::time_point end)
+{
+    enqueue({OpKind::RemoveRange, nullptr, std::string(), 0, start, end});
+    return true;
+}
+
+bool WriteBehindScheduleDatabase::addTombstone(const Event &e, std::chrono::system_clock::time_point deletedAt)
+{
+    enqueue({OpKind::AddTombstone, e.clone(), e.getId(), 0, deletedAt});
+    return true;
+}
+
+bool WriteBehindScheduleDatabase::removeTombstone(const std::string &id)
+{
+    enqueue({OpKind::RemoveTombstone, nullptr, id, 0});
+    return true;
+}
+
+bool WriteBehindScheduleDatabase::purgeTombstones(std::chrono::system_clock::time_point cutoff)
+{
+    enqueue({OpKind::PurgeTombstones, nullptr, std::string(), 0, cutoff});
+    return true;
+}
+
+std::vector<std::unique_ptr<Event>> WriteBehindScheduleDatabase::getAllEvents() const
+{
+    waitUntilDurable();
+    return inner_->getAllEvents();
+}
+
+std::vector<std::unique_ptr<Event>> WriteBehindScheduleDatabase::getEventsInRange(std::chrono::system_clock::time_point start,
+                                                                                  std::chrono::system_clock::time_point end,
+                                                                                  size_t limit) const
+{
+    waitUntilDurable();
+    return inner_->getEventsInRange(start, end, limit);
+}
+
+size_t WriteBehindScheduleDatabase::countEventsInRange(std::chrono::system_clock::time_point start,
+                                                       std::chrono::system_clock::time_point end) const
+{
+    waitUntilDurable();
+    return inner_->countEventsInRange(start, end);
+}
+
+std::vector<std::unique_ptr<Event>> WriteBehindScheduleDatabase::getRecurringEvents() const
+{
+    waitUntilDurable();
+    return inner_->getRecurringEvents();
+}
+
+std::unique_ptr<Event> WriteBehindScheduleDatabase::getEventById(const std::string &id) const
+{
+    waitUntilDurable();
+    return inner_->getEventById(id);
+}
+
+std::chrono::seconds WriteBehindScheduleDatabase::getLongestDuration() const
+{
+    waitUntilDurable();
+    return inner_->getLongestDuration();
+}
+
+std::unique_ptr<Event> WriteBehindScheduleDatabase::getTombstone(const std::string &id) const
+{
+    waitUntilDurable();
+    return inner_->getTombstone(id);
+}
+
+std::vector<std::unique_ptr<Event>> WriteBehindScheduleDatabase::getTombstones(size_t offset, size_t limit) const
+{
+    waitUntilDurable();
+    return inner_->getTombstones(offset, limit);
+}
+
+std::vector<std::pair<std::string, std::chrono::system_clock::time_point>> WriteBehindScheduleDatabase::getTombstoneIds() const
+{
+    waitUntilDurable();
+    return inner_->getTombstoneIds();
+}
+
+bool WriteBehindScheduleDatabase::beginTransaction()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (inTransaction_ && transactionOwner_ == std::this_thread::get_id())
+        return false;
+    transactionDone_.wait(lock, [&]
+                          { return !inTransaction_; });
+    inTransaction_ = true;
+    transactionOwner_ = std::this_thread::get_id();
+    return true;
+}
+
+bool WriteBehindScheduleDatabase::commitTransaction()
+{
+    bool full;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!inTransaction_ || transactionOwner_ != std::this_thread::get_id())
+            return false;
+        inTransaction_ = false;
+        full = pushLocked(std::move(staged_));
+        staged_.clear();
+    }
+    transactionDone_.notify_one();
+    if (full)
+        wake_.notify_one();
+    return true;
+}
+
+bool WriteBehindScheduleDatabase::rollbackTransaction()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!inTransaction_ || transactionOwner_ != std::this_thread::get_id())
+            return false;
+        inTransaction_ = false;
+        staged_.clear();
+    }
+    transactionDone_.notify_one();
+    return true;
+}
+
+bool WriteBehindScheduleDatabase::flush()
+{
+    return waitUntilDurable();
+}
+
+size_t WriteBehindScheduleDatabase::pendingWrites() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+uint64_t WriteBehindScheduleDatabase::committedBatches() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return batches_;
+}
+
+uint64_t WriteBehindScheduleDatabase::lostWrites() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lostWrites_;
+}
+
+void WriteBehindScheduleDatabase::enqueue(Op op)
+{
+    bool full;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        full = acceptLocked(std::move(op));
+    }
+    if (full)
+        wake_.notify_one();
+}
+
+bool WriteBehindScheduleDatabase::acceptLocked(Op op)
+{
+    if (inTransaction_ && transactionOwner_ == std::this_thread::get_id())
+    {
+        staged_.push_back(std::move(op));
+        return false;
+    }
+    std::vector<Op> ops;
+    ops.push_back(std::move(op));
+    return pushLocked(std::move(ops));
+}
+
+bool WriteBehindScheduleDatabase::pushLocked(std::vector<Op> ops)
+{
+    const uint64_t unit = enqueuedSeq_ + 1;
+    for (auto &op : ops)
+    {
+        op.seq = ++enqueuedSeq_;
+        op.unit = unit;
+        // Clearing the table makes every earlier pending event write moot;
+        // tombstones live in their own table and keep their writes
+        if (op.kind == OpKind::RemoveAll)
+            queue_.erase(std::remove_if(queue_.begin(), queue_.end(), [](const Op &pending)
+                                        { return pending.kind == OpKind::Add || pending.kind == OpKind::Update ||
+                                                 pending.kind == OpKind::Remove || pending.kind == OpKind::RemoveRange; }),
+                         queue_.end());
+        queue_.push_back(std::move(op));
+    }
+    return queue_.size() >= batchSize_;
+}
+
+bool WriteBehindScheduleDatabase::waitUntilDurable() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint64_t target = enqueuedSeq_;
+    if (settledSeq_ < target)
+    {
+        flushRequested_ = true;
+        wake_.notify_one();
+        committed_.wait(lock, [&]
+                        { return settledSeq_ >= target; });
+    }
+    return committedSeq_ >= target;
+}
+
+void WriteBehindScheduleDatabase::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        wake_.wait_for(lock, flushInterval_, [&]
+                       { return stopping_ || flushRequested_ || queue_.size() >= batchSize_; });
+
+        if (queue_.empty())
+        {
+            flushRequested_ = false;
+            if (stopping_)
+                break;
+            continue;
+        }
+
+        // A unit may run the batch past batchSize_, never split it
+        std::deque<Op> batch;
+        while (!queue_.empty() && (batch.size() < batchSize_ || queue_.front().unit == batch.back().unit))
+        {
+            batch.push_back(std::move(queue_.front()));
+            queue_.pop_front();
+        }
+        // Keep draining without waiting if a flush is still owed
+        flushRequested_ = flushRequested_ && !queue_.empty();
+        uint64_t lastSeq = batch.back().seq;
+
+        lock.unlock();
+        bool ok = commitBatch(batch);
+        // A failed batch was rolled back whole, so replaying it is safe
+        for (int attempt = 1; !ok && attempt < kCommitAttempts; ++attempt)
+        {
+            std::this_thread::sleep_for(std::min(flushInterval_, std::chrono::milliseconds(100)) * attempt);
+            ok = commitBatch(batch);
+        }
+        lock.lock();
+
+        if (ok)
+        {
+            // Only a prefix with nothing lost in it counts as committed
+            if (committedSeq_ == settledSeq_)
+                committedSeq_ = lastSeq;
+            ++batches_;
+        }
+        else
+        {
+            Logger::error("[write-behind] giving up on ", batch.size(), " writes after ", kCommitAttempts,
+                          " attempts");
+            lostWrites_ += batch.size();
+        }
+        settledSeq_ = lastSeq;
+        committed_.notify_all();
+    }
+}
+
+bool WriteBehindScheduleDatabase::commitBatch(const std::deque<Op> &batch)
+{
+    bool inTransaction = inner_->beginTransaction();
+    if (!inTransaction)
+        Logger::warn("[write-behind] could not open a transaction; writing ", batch.size(), " rows individually");
+
+    try
+    {
+        bool allOk = true;
+        for (const auto &op : batch)
+        {
+            bool ok = true;
+            switch (op.kind)
+            {
+            case OpKind::Add:
+                ok = inner_->addEvent(*op.event);
+                break;
+            case OpKind::Update:
+                ok = inner_->updateFields(*op.event, op.fields);
+                break;
+            case OpKind::Remove:
+                ok = inner_->removeEvent(op.id);
+                break;
+            case OpKind::RemoveRange:
+                ok = inner_->removeEventsInRange(op.when, op.until);
+                break;
+            case OpKind::RemoveAll:
+                ok = inner_->removeAllEvents();
+                break;
+            case OpKind::AddTombstone:
+                ok = inner_->addTombstone(*op.event, op.when);
+                break;
+            case OpKind::RemoveTombstone:
+                ok = inner_->removeTombstone(op.id);
+                break;
+            case OpKind::PurgeTombstones:
+                ok = inner_->purgeTombstones(op.when);
+                break;
+            }
+            if (!ok)
+            {
+                Logger::warn("[write-behind] failed to persist change for event '", op.id, "'");
+                allOk = false;
+                if (inTransaction)
+                    break;
+            }
+        }
+        if (!allOk)
+        {
+            if (inTransaction)
+                inner_->rollbackTransaction();
+            return false;
+        }
+        if (inTransaction && !inner_->commitTransaction())
+        {
+            Logger::error("[write-behind] commit failed; rolling back ", batch.size(), " writes");
+            inner_->rollbackTransaction();
+            return false;
+        }
+        return true;
+    }
+    catch (const std::exception &ex)
+    {
+        Logger::error("[write-behind] batch aborted: ", ex.what());
+        if (inTransaction)
+            inner_->rollbackTransaction();
+        return false;
+    }
+}
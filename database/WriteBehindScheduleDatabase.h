@@ -0,0 +1,132 @@
+#pragma once
+
+#include "IScheduleDatabase.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/*
+  Write-behind journal in front of another IScheduleDatabase.
+  Writes are queued in memory and return immediately; a persister thread
+  drains the queue in batches, wrapping each batch in a single transaction
+  so a burst of writes costs one commit instead of one per row. A batch is
+  committed when `batchSize` writes are waiting, when `flushInterval` has
+  passed, or when someone calls flush().
+
+  A batch that fails to commit is rolled back and retried a few times. If
+  it still fails its writes are dropped, and from then on flush() returns
+  false and lostWrites() counts them, since they were already acknowledged.
+
+  Writes made between beginTransaction() and commitTransaction() on one
+  thread are held back and queued together at commit as a single unit,
+  which a batch never splits; rollbackTransaction() discards them. The
+  same holds for each writeEvents() call. Reads inside a transaction do
+  not see its held-back writes.
+*/
+class WriteBehindScheduleDatabase : public IScheduleDatabase {
+public:
+    explicit WriteBehindScheduleDatabase(std::shared_ptr<IScheduleDatabase> inner,
+                                         std::chrono::milliseconds flushInterval = std::chrono::milliseconds(50),
+                                         size_t batchSize = 256);
+    ~WriteBehindScheduleDatabase() override;
+
+    WriteBehindScheduleDatabase(const WriteBehindScheduleDatabase &) = delete;
+    WriteBehindScheduleDatabase &operator=(const WriteBehindScheduleDatabase &) = delete;
+
+    // Queued; the result only reports that the write was accepted.
+    bool addEvent(const Event &e) override;
+    bool removeEvent(const std::string &id) override;
+    bool removeAllEvents() override;
+    bool writeEvents(const std::vector<EventWrite> &writes) override;
+    bool updateFields(const Event &e, uint16_t fields) override;
+    bool removeEventsInRange(std::chrono::system_clock::time_point start,
+                             std::chrono::system_clock::time_point end) override;
+    bool addTombstone(const Event &e, std::chrono::system_clock::time_point deletedAt) override;
+    bool removeTombstone(const std::string &id) override;
+    bool purgeTombstones(std::chrono::system_clock::time_point cutoff) override;
+
+    bool storesTombstones() const override { return inner_->storesTombstones(); }
+
+    // One transaction at a time: begin waits for another thread's
+    // transaction to finish, and fails if this thread already has one open.
+    bool beginTransaction() override;
+    bool commitTransaction() override;
+    bool rollbackTransaction() override;
+
+    // Reads flush pending writes first so the result reflects them.
+    std::vector<std::unique_ptr<Event>> getAllEvents() const override;
+    std::vector<std::unique_ptr<Event>> getEventsInRange(std::chrono::system_clock::time_point start,
+                                                         std::chrono::system_clock::time_point end,
+                                                         size_t limit) const override;
+    size_t countEventsInRange(std::chrono::system_clock::time_point start,
+                              std::chrono::system_clock::time_point end) const override;
+    std::vector<std::unique_ptr<Event>> getRecurringEvents() const override;
+    std::unique_ptr<Event> getEventById(const std::string &id) const override;
+    std::chrono::seconds getLongestDuration() const override;
+    std::unique_ptr<Event> getTombstone(const std::string &id) const override;
+    std::vector<std::unique_ptr<Event>> getTombstones(size_t offset, size_t limit) const override;
+    std::vector<std::pair<std::string, std::chrono::system_clock::time_point>> getTombstoneIds() const override;
+
+    // Durability barrier: returns once every write queued before the call
+    // has been committed to the inner store or given up on. False if any
+    // write up to that point was lost.
+    bool flush() override;
+
+    size_t pendingWrites() const;
+    uint64_t committedBatches() const;
+    // Acknowledged writes whose batch could not be committed
+    uint64_t lostWrites() const;
+
+private:
+    enum class OpKind { Add, Update, Remove, RemoveRange, RemoveAll, AddTombstone, RemoveTombstone, PurgeTombstones };
+    struct Op {
+        OpKind kind;
+        std::unique_ptr<Event> event;
+        std::string id;
+        uint64_t seq;
+        std::chrono::system_clock::time_point when{}; // deletion time, purge cutoff or range start
+        std::chrono::system_clock::time_point until{}; // range end
+        uint16_t fields = 0;                           // columns an Update writes
+        uint64_t unit = 0;                             // ops sharing a unit commit in one batch
+    };
+
+    void enqueue(Op op);
+    // Caller holds mutex_. Holds the op back if this thread has a
+    // transaction open, else queues it; true once a full batch is waiting.
+    bool acceptLocked(Op op);
+    // Caller holds mutex_; queues the ops as one unit. True once a full
+    // batch is waiting.
+    bool pushLocked(std::vector<Op> ops);
+    // Waits for every write queued so far to settle; true if all committed.
+    bool waitUntilDurable() const;
+    void run();
+    // Applies the batch in one transaction; false if it was rolled back or
+    // any write in it failed.
+    bool commitBatch(const std::deque<Op> &batch);
+
+    std::shared_ptr<IScheduleDatabase> inner_;
+    std::chrono::milliseconds flushInterval_;
+    size_t batchSize_;
+
+    mutable std::mutex mutex_;
+    mutable std::condition_variable wake_;      // persister waits here
+    mutable std::condition_variable committed_; // flush() callers wait here
+    std::deque<Op> queue_;
+    uint64_t enqueuedSeq_ = 0;
+    uint64_t settledSeq_ = 0;   // every write up to here is committed or lost
+    uint64_t committedSeq_ = 0; // every write up to here is committed
+    uint64_t batches_ = 0;
+    uint64_t lostWrites_ = 0;
+    mutable bool flushRequested_ = false;
+    bool inTransaction_ = false;
+    std::thread::id transactionOwner_;
+    std::vector<Op> staged_;                    // writes of the open transaction
+    std::condition_variable transactionDone_;   // beginTransaction() waits here
+    bool stopping_ = false;
+    std::thread worker_;
+};
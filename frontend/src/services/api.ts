@@ -1,4 +1,4 @@
-import { Event, ApiResponse, TimeSlot, EventStats, CreateRecurringEventRequest, RecurringEvent } from '../types';
+import { Event, ApiResponse, TimeSlot, EventStats, CreateRecurringEventRequest, RecurringEvent, EventChanges, EventChangesResponse } from '../types';
 
 const API_BASE_URL = process.env.REACT_APP_API_URL || 'http://localhost:8080';
 const API_KEY = process.env.REACT_APP_API_KEY || 'changeme';
@@ -108,6 +108,19 @@ class ApiClient {
     });
   }
 
+  // Events added, changed or deleted since `since` (the version from
+  // getEvents or an earlier call)
+  async getChanges(since: number): Promise<EventChangesResponse> {
+    const response: EventChangesResponse = await this.request<EventChanges>(`/events/changes?since=${since}`);
+
+    // Convert duration from seconds (backend) to minutes (frontend)
+    if (response.status === 'ok' && response.data) {
+      response.data.upserts = this.convertEventsDuration(response.data.upserts);
+    }
+
+    return response;
+  }
+
   async getNextEvent(): Promise<ApiResponse<Event>> {
     const response = await this.request<Event>('/events/next');
     
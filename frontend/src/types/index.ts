@@ -56,4 +56,17 @@ export interface ApiResponse<T = any> {
   status: 'ok' | 'error';
   data?: T;
   message?: string;
+  // Change version, on /events and /events/changes responses
+  version?: number;
+}
+
+// Delta from GET /events/changes. When resync is true the server no longer
+// has every change since the given version; fetch /events again.
+export interface EventChanges {
+  upserts: Event[];
+  deletes: string[];
+}
+
+export interface EventChangesResponse extends ApiResponse<EventChanges> {
+  resync?: boolean;
 }
\ No newline at end of file
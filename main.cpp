@@ -1,6 +1,7 @@
 // main_solid.cpp - SOLID Principles Implementation
 #include "model/Model.h"
 #include "database/SQLiteScheduleDatabase.h"
+#include "database/WriteBehindScheduleDatabase.h"
 #include "api/ApiServer.h"
 #include "services/EventService.h"
 #include "scheduler/EventLoop.h"
@@ -19,6 +20,7 @@
 #include <vector>
 #include <memory>
 #include <chrono>
+#include <iostream>
 
 int main()
 {
@@ -29,10 +31,26 @@ int main()
     DependencyContainer container;
     
     // Register core components following DIP
-    auto db = std::make_shared<SQLiteScheduleDatabase>("events.db");
-    container.registerSingleton<SQLiteScheduleDatabase>(db);
+    auto sqlite = std::make_shared<SQLiteScheduleDatabase>("events.db");
+    container.registerSingleton<SQLiteScheduleDatabase>(sqlite);
+
+    // Write-behind journal: batch SQLite commits off the request path
+    std::shared_ptr<IScheduleDatabase> db = sqlite;
+    const char *writeBehind = getenv("DB_WRITE_BEHIND");
+    if (writeBehind && std::string(writeBehind) == "1") {
+        const char *flushMs = getenv("DB_FLUSH_INTERVAL_MS");
+        const char *batch = getenv("DB_BATCH_SIZE");
+        auto journal = std::make_shared<WriteBehindScheduleDatabase>(
+            sqlite,
+            std::chrono::milliseconds(flushMs ? std::stoi(flushMs) : 50),
+            batch ? std::stoul(batch) : 256);
+        container.registerSingleton<WriteBehindScheduleDatabase>(journal);
+        db = journal;
+    }
     
-    auto model = std::make_shared<Model>(db.get());
+    // Paging: keep only this many days either side of now in memory
+    const char *windowDays = getenv("MODEL_WINDOW_DAYS");
+    auto model = std::make_shared<Model>(db.get(), windowDays ? std::stoi(windowDays) : -1);
     container.registerSingleton<Model>(model);
     
     // Register calendar API
@@ -148,6 +166,8 @@ int main()
     api.start();
 
     eventLoop->stop();
+    if (!model->flush())
+        std::cerr << "Some changes could not be saved to the database\n";
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "ChangeLog.h"
+#include <chrono>
+
+ChangeLog::ChangeLog(size_t capacity)
+    : capacity_(capacity == 0 ? 1 : capacity)
+{
+    ring_.resize(capacity_);
+    version_ = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                         std::chrono::system_clock::now().time_since_epoch())
+                                         .count());
+    floor_ = version_;
+}
+
+void ChangeLog::record(Kind kind, const std::string &id)
+{
+    auto &slot = ring_[next_];
+    slot.version = ++version_;
+    slot.kind = kind;
+    slot.id = id;
+    next_ = (next_ + 1) % capacity_;
+    if (count_ < capacity_)
+        ++count_;
+    else
+        floor_ = version_ - count_; // the oldest record was just overwritten
+}
+
+void ChangeLog::reset()
+{
+    count_ = 0;
+    floor_ = ++version_;
+}
+
+bool ChangeLog::since(uint64_t since, std::vector<Record> &out) const
+{
+    if (since < floor_ || since > version_)
+        return false;
+    // Versions are consecutive, so the wanted records are the newest ones
+    size_t wanted = static_cast<size_t>(version_ - since);
+    size_t slot = (next_ + capacity_ - wanted) % capacity_;
+    out.reserve(out.size() + wanted);
+    for (size_t i = 0; i < wanted; ++i)
+    {
+        out.push_back(ring_[slot]);
+        slot = (slot + 1) % capacity_;
+    }
+    return true;
+}
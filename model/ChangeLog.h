@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+  Bounded log of recent changes, for clients that sync by delta.
+  Every change takes the next version number and the newest `capacity`
+  records are kept in a ring. A client remembers the version it last saw
+  and asks for what came after; once the ring has overwritten records it
+  still needs, it has to fetch everything again.
+
+  Versions start from the wall clock in microseconds, so they keep growing
+  across restarts and a version handed out by an earlier process is never
+  taken for one of ours.
+*/
+class ChangeLog
+{
+public:
+    enum class Kind : uint8_t
+    {
+        Upsert,
+        Delete
+    };
+
+    struct Record
+    {
+        uint64_t version;
+        Kind kind;
+        std::string id;
+    };
+
+    explicit ChangeLog(size_t capacity = 4096);
+
+    // Version of the latest change
+    uint64_t version() const { return version_; }
+
+    void record(Kind kind, const std::string &id);
+
+    // A change too broad to list, such as clearing the model: drop every
+    // record so clients behind it resync.
+    void reset();
+
+    // Append the records newer than `since`, oldest first. False when some
+    // of them are gone or `since` is not a version this log issued.
+    bool since(uint64_t since, std::vector<Record> &out) const;
+
+private:
+    std::vector<Record> ring_;
+    size_t capacity_;
+    size_t next_ = 0;  // slot the next record goes to
+    size_t count_ = 0; // records held
+    uint64_t version_;
+    // Oldest version a client can resume from
+    uint64_t floor_;
+};
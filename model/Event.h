@@ -2,10 +2,30 @@
 
 #include <string>
 #include <chrono>
+#include <cstdint>
 #include <memory>
+#include "../utils/InternPool.h"
 
 class Event
 {
+public:
+    // Stored fields the setters below track, so a store can write back only
+    // the columns an edit touched. Identity and recurrence are not tracked:
+    // changing those means writing the whole row.
+    enum Field : uint16_t
+    {
+        kDescription = 1 << 0,
+        kTitle = 1 << 1,
+        kTime = 1 << 2,
+        kDuration = 1 << 3,
+        kCategory = 1 << 4,
+        kProviderEventId = 1 << 5,
+        kProviderTaskId = 1 << 6,
+        kNotifier = 1 << 7,
+        kAction = 1 << 8,
+        kAllFields = (1 << 9) - 1,
+    };
+
 protected:
     std::string id;
     std::string description;
@@ -14,13 +34,15 @@ protected:
     std::chrono::system_clock::time_point timeUtc;
     std::chrono::system_clock::duration duration;
     bool recurringFlag;
-    std::string category; // New member for category support
+    InternPool::Handle category; // Interned: a handful of values repeat across events
     // External provider IDs (e.g., Google Calendar/Tasks)
     std::string providerEventId_;
     std::string providerTaskId_;
     // Optional task metadata: names registered in notifier/action registries
-    std::string notifierName_;
-    std::string actionName_;
+    InternPool::Handle notifierName_ = InternPool::kEmpty;
+    InternPool::Handle actionName_ = InternPool::kEmpty;
+    // Field bits set since construction or the last clearDirty()
+    uint16_t dirty_ = 0;
 
 public:
     // Updated constructor with optional category parameter
@@ -36,7 +58,7 @@ public:
           timeUtc(time),
           duration(duration),
           recurringFlag(false),
-          category(category) {}
+          category(InternPool::intern(category)) {}
 
     virtual ~Event() = default;
 
@@ -57,27 +79,42 @@ public:
     // Returned value is in UTC
     std::chrono::system_clock::time_point getTime() const { return timeUtc; }
     std::chrono::system_clock::duration getDuration() const { return duration; }
-    std::string getId() const { return id; }
-    std::string getDescription() const { return description; }
-    std::string getTitle() const { return title; }
+    const std::string &getId() const { return id; }
+    const std::string &getDescription() const { return description; }
+    const std::string &getTitle() const { return title; }
     bool isRecurring() const { return recurringFlag; }
-    std::string getCategory() const { return category; }
-    std::string getProviderEventId() const { return providerEventId_; }
-    std::string getProviderTaskId() const { return providerTaskId_; }
-    std::string getNotifierName() const { return notifierName_; }
-    std::string getActionName() const { return actionName_; }
+    const std::string &getCategory() const { return InternPool::str(category); }
+    const std::string &getProviderEventId() const { return providerEventId_; }
+    const std::string &getProviderTaskId() const { return providerTaskId_; }
+    const std::string &getNotifierName() const { return InternPool::str(notifierName_); }
+    const std::string &getActionName() const { return InternPool::str(actionName_); }
+
+    // Interned handles, for callers that group or compare by name
+    InternPool::Handle getCategoryHandle() const { return category; }
+    InternPool::Handle getNotifierHandle() const { return notifierName_; }
+    InternPool::Handle getActionHandle() const { return actionName_; }
 
     // ===== Setter methods for updates =====
 
-    void setDescription(const std::string &desc) { description = desc; }
-    void setTitle(const std::string &newTitle) { title = newTitle; }
-    void setTime(std::chrono::system_clock::time_point newTime) { timeUtc = newTime; }
-    void setDuration(std::chrono::system_clock::duration newDuration) { duration = newDuration; }
-    void setCategory(const std::string &newCategory) { category = newCategory; }
-    void setProviderEventId(const std::string &pid) { providerEventId_ = pid; }
-    void setProviderTaskId(const std::string &pid) { providerTaskId_ = pid; }
-    void setNotifierName(const std::string &name) { notifierName_ = name; }
-    void setActionName(const std::string &name) { actionName_ = name; }
+    void setDescription(const std::string &desc) { description = desc; dirty_ |= kDescription; }
+    void setTitle(const std::string &newTitle) { title = newTitle; dirty_ |= kTitle; }
+    void setTime(std::chrono::system_clock::time_point newTime) { timeUtc = newTime; dirty_ |= kTime; }
+    void setDuration(std::chrono::system_clock::duration newDuration) { duration = newDuration; dirty_ |= kDuration; }
+    void setCategory(const std::string &newCategory) { category = InternPool::intern(newCategory); dirty_ |= kCategory; }
+    void setCategoryHandle(InternPool::Handle h) { category = h; dirty_ |= kCategory; }
+    void setProviderEventId(const std::string &pid) { providerEventId_ = pid; dirty_ |= kProviderEventId; }
+    void setProviderTaskId(const std::string &pid) { providerTaskId_ = pid; dirty_ |= kProviderTaskId; }
+    void setNotifierName(const std::string &name) { notifierName_ = InternPool::intern(name); dirty_ |= kNotifier; }
+    void setActionName(const std::string &name) { actionName_ = InternPool::intern(name); dirty_ |= kAction; }
+    void setNotifierHandle(InternPool::Handle h) { notifierName_ = h; dirty_ |= kNotifier; }
+    void setActionHandle(InternPool::Handle h) { actionName_ = h; dirty_ |= kAction; }
+
+    // ===== Dirty-field tracking =====
+
+    // Field bits changed through the setters since construction or the
+    // last clearDirty(); clones carry them over
+    uint16_t dirtyFields() const { return dirty_; }
+    void clearDirty() { dirty_ = 0; }
 
     // ===== Comparison operators for sorting =====
 
@@ -0,0 +1,294 @@
+#include "EventSnapshot.h"
+#include <algorithm>
+
+namespace
+{
+    template <typename T>
+    void eraseAt(std::vector<T> &v, size_t pos)
+    {
+        v.erase(v.begin() + static_cast<std::ptrdiff_t>(pos));
+    }
+
+    template <typename T>
+    void insertAt(std::vector<T> &v, size_t pos, T value)
+    {
+        v.insert(v.begin() + static_cast<std::ptrdiff_t>(pos), std::move(value));
+    }
+
+    template <typename T>
+    void eraseRange(std::vector<T> &v, size_t from, size_t to)
+    {
+        v.erase(v.begin() + static_cast<std::ptrdiff_t>(from), v.begin() + static_cast<std::ptrdiff_t>(to));
+    }
+
+    template <typename T>
+    void appendFrom(std::vector<T> &to, const std::vector<T> &from, size_t start)
+    {
+        to.insert(to.end(), from.begin() + static_cast<std::ptrdiff_t>(start), from.end());
+    }
+} // namespace
+
+// ===== Chunk =====
+
+void EventSnapshot::Chunk::insertAt(size_t pos, EventPtr event)
+{
+    ::insertAt(starts, pos, event->getTime());
+    ::insertAt(durations, pos, event->getDuration());
+    ::insertAt(flags, pos, static_cast<uint8_t>(event->isRecurring() ? kRecurring : 0));
+    ::insertAt(categoryIds, pos, event->getCategoryHandle());
+    ::insertAt(events, pos, std::move(event));
+}
+
+void EventSnapshot::Chunk::eraseAt(size_t pos)
+{
+    ::eraseAt(starts, pos);
+    ::eraseAt(durations, pos);
+    ::eraseAt(flags, pos);
+    ::eraseAt(categoryIds, pos);
+    ::eraseAt(events, pos);
+}
+
+void EventSnapshot::Chunk::setAt(size_t pos, EventPtr event)
+{
+    starts[pos] = event->getTime();
+    durations[pos] = event->getDuration();
+    flags[pos] = static_cast<uint8_t>(event->isRecurring() ? kRecurring : 0);
+    categoryIds[pos] = event->getCategoryHandle();
+    events[pos] = std::move(event);
+}
+
+void EventSnapshot::Chunk::append(const Chunk &other, size_t from)
+{
+    appendFrom(starts, other.starts, from);
+    appendFrom(durations, other.durations, from);
+    appendFrom(flags, other.flags, from);
+    appendFrom(categoryIds, other.categoryIds, from);
+    appendFrom(events, other.events, from);
+}
+
+void EventSnapshot::Chunk::eraseRange(size_t from, size_t to)
+{
+    ::eraseRange(starts, from, to);
+    ::eraseRange(durations, from, to);
+    ::eraseRange(flags, from, to);
+    ::eraseRange(categoryIds, from, to);
+    ::eraseRange(events, from, to);
+}
+
+void EventSnapshot::Chunk::truncate(size_t n)
+{
+    starts.resize(n);
+    durations.resize(n);
+    flags.resize(n);
+    categoryIds.resize(n);
+    events.resize(n);
+}
+
+// ===== Lookup =====
+
+template <typename Before>
+EventSnapshot::const_iterator EventSnapshot::bound(TimePoint t, Before before) const
+{
+    // Chunks are sorted and non-empty, so compare against each chunk's last start
+    auto chunk = std::partition_point(chunks_.begin(), chunks_.end(),
+                                      [&](const std::shared_ptr<Chunk> &c)
+                                      { return before(c->starts.back(), t); });
+    if (chunk == chunks_.end())
+        return end();
+    const auto &starts = (*chunk)->starts;
+    auto pos = std::partition_point(starts.begin(), starts.end(),
+                                    [&](TimePoint s)
+                                    { return before(s, t); });
+    return const_iterator(&chunks_, static_cast<size_t>(chunk - chunks_.begin()),
+                          static_cast<size_t>(pos - starts.begin()));
+}
+
+EventSnapshot::const_iterator EventSnapshot::lowerBound(TimePoint t) const
+{
+    return bound(t, [](TimePoint a, TimePoint b)
+                 { return a < b; });
+}
+
+EventSnapshot::const_iterator EventSnapshot::upperBound(TimePoint t) const
+{
+    return bound(t, [](TimePoint a, TimePoint b)
+                 { return a <= b; });
+}
+
+// ===== Builder =====
+
+EventSnapshot::Builder::Builder(const std::shared_ptr<const EventSnapshot> &base)
+{
+    if (base)
+    {
+        chunks_ = base->chunks_;
+        size_ = base->size_;
+    }
+    owned_.assign(chunks_.size(), false);
+}
+
+EventSnapshot::Chunk &EventSnapshot::Builder::mutableChunk(size_t index)
+{
+    if (!owned_[index])
+    {
+        chunks_[index] = std::make_shared<Chunk>(*chunks_[index]);
+        owned_[index] = true;
+    }
+    return *chunks_[index];
+}
+
+void EventSnapshot::Builder::insert(EventPtr event)
+{
+    auto t = event->getTime();
+    if (chunks_.empty())
+    {
+        chunks_.push_back(std::make_shared<Chunk>());
+        chunks_.back()->insertAt(0, std::move(event));
+        owned_.push_back(true);
+        ++size_;
+        return;
+    }
+
+    // Last chunk that can hold `t` without breaking order; append to the tail otherwise
+    auto it = std::partition_point(chunks_.begin(), chunks_.end(),
+                                   [&](const std::shared_ptr<Chunk> &c)
+                                   { return c->starts.back() <= t; });
+    size_t index = it == chunks_.end() ? chunks_.size() - 1 : static_cast<size_t>(it - chunks_.begin());
+
+    auto &chunk = mutableChunk(index);
+    auto pos = std::partition_point(chunk.starts.begin(), chunk.starts.end(),
+                                    [&](TimePoint s)
+                                    { return s <= t; });
+    chunk.insertAt(static_cast<size_t>(pos - chunk.starts.begin()), std::move(event));
+    ++size_;
+    rebalance(index);
+}
+
+bool EventSnapshot::Builder::locate(const Event *event, size_t &chunk, size_t &pos) const
+{
+    auto t = event->getTime();
+    auto it = std::partition_point(chunks_.begin(), chunks_.end(),
+                                   [&](const std::shared_ptr<Chunk> &c)
+                                   { return c->starts.back() < t; });
+    for (chunk = static_cast<size_t>(it - chunks_.begin()); chunk < chunks_.size(); ++chunk)
+    {
+        const auto &c = *chunks_[chunk];
+        auto first = std::partition_point(c.starts.begin(), c.starts.end(),
+                                          [&](TimePoint s)
+                                          { return s < t; });
+        // Equal start times may straddle a chunk boundary
+        for (pos = static_cast<size_t>(first - c.starts.begin()); pos < c.size(); ++pos)
+        {
+            if (c.starts[pos] != t)
+                return false;
+            if (c.events[pos].get() == event)
+                return true;
+        }
+    }
+    return false;
+}
+
+bool EventSnapshot::Builder::erase(const Event *event)
+{
+    size_t chunk, pos;
+    if (!locate(event, chunk, pos))
+        return false;
+    mutableChunk(chunk).eraseAt(pos);
+    --size_;
+    rebalance(chunk);
+    return true;
+}
+
+bool EventSnapshot::Builder::replace(const Event *current, EventPtr next)
+{
+    size_t chunk, pos;
+    if (!locate(current, chunk, pos))
+        return false;
+    mutableChunk(chunk).setAt(pos, std::move(next));
+    return true;
+}
+
+size_t EventSnapshot::Builder::eraseRange(TimePoint start, TimePoint end)
+{
+    if (!(start < end))
+        return 0;
+    // First chunk holding anything at or after `start`
+    auto it = std::partition_point(chunks_.begin(), chunks_.end(),
+                                   [&](const std::shared_ptr<Chunk> &c)
+                                   { return c->starts.back() < start; });
+    const size_t first = static_cast<size_t>(it - chunks_.begin());
+    size_t removed = 0;
+    size_t index = first;
+    while (index < chunks_.size() && chunks_[index]->starts.front() < end)
+    {
+        const auto &starts = chunks_[index]->starts;
+        size_t from = static_cast<size_t>(std::lower_bound(starts.begin(), starts.end(), start) - starts.begin());
+        size_t to = static_cast<size_t>(std::lower_bound(starts.begin(), starts.end(), end) - starts.begin());
+        removed += to - from;
+        if (from == 0 && to == starts.size())
+        {
+            chunks_.erase(chunks_.begin() + static_cast<std::ptrdiff_t>(index));
+            owned_.erase(owned_.begin() + static_cast<std::ptrdiff_t>(index));
+            continue;
+        }
+        mutableChunk(index).eraseRange(from, to);
+        ++index;
+    }
+    size_ -= removed;
+
+    // Only the two edge chunks were trimmed, and they are now neighbours
+    if (first + 1 < chunks_.size())
+        rebalance(first + 1);
+    if (first < chunks_.size())
+        rebalance(first);
+    return removed;
+}
+
+void EventSnapshot::Builder::clear()
+{
+    chunks_.clear();
+    owned_.clear();
+    size_ = 0;
+}
+
+void EventSnapshot::Builder::rebalance(size_t index)
+{
+    size_t count = chunks_[index]->size();
+    if (count > kMaxChunk)
+    {
+        auto tail = std::make_shared<Chunk>();
+        auto &head = mutableChunk(index);
+        tail->append(head, count / 2);
+        head.truncate(count / 2);
+        chunks_.insert(chunks_.begin() + static_cast<std::ptrdiff_t>(index + 1), std::move(tail));
+        owned_.insert(owned_.begin() + static_cast<std::ptrdiff_t>(index + 1), true);
+        return;
+    }
+    if (count == 0)
+    {
+        chunks_.erase(chunks_.begin() + static_cast<std::ptrdiff_t>(index));
+        owned_.erase(owned_.begin() + static_cast<std::ptrdiff_t>(index));
+        return;
+    }
+    if (count >= kMinChunk || chunks_.size() < 2)
+        return;
+
+    // Fold a small chunk into a neighbour so scans don't degrade into pointer hops
+    size_t left = index + 1 < chunks_.size() ? index : index - 1;
+    size_t right = left + 1;
+    if (chunks_[left]->size() + chunks_[right]->size() > kMaxChunk)
+        return;
+    mutableChunk(left).append(*chunks_[right], 0);
+    chunks_.erase(chunks_.begin() + static_cast<std::ptrdiff_t>(right));
+    owned_.erase(owned_.begin() + static_cast<std::ptrdiff_t>(right));
+}
+
+std::shared_ptr<const EventSnapshot> EventSnapshot::Builder::build()
+{
+    auto snapshot = std::make_shared<EventSnapshot>();
+    snapshot->chunks_ = chunks_;
+    snapshot->size_ = size_;
+    // Published chunks are frozen; further edits must copy them again
+    owned_.assign(chunks_.size(), false);
+    return snapshot;
+}
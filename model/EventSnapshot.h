@@ -0,0 +1,154 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <vector>
+#include "Event.h"
+
+/*
+  Immutable, time-ordered view of the schedule.
+  Events are shared and const, and live in small sorted chunks. Each chunk
+  keeps the fields scans filter on (start, duration, flags, category handle) in
+  parallel contiguous arrays, so a range or duration scan streams through
+  those and only touches an Event, with its strings, for rows it returns. A writer
+  derives the next snapshot through EventSnapshot::Builder, which copies
+  only the chunk list and the chunks it actually touches; everything else
+  is shared with the previous snapshot. Readers that hold a snapshot see a
+  consistent schedule for as long as they keep it, without any locking.
+*/
+class EventSnapshot
+{
+public:
+    using TimePoint = std::chrono::system_clock::time_point;
+    using EventPtr = std::shared_ptr<const Event>;
+    using Duration = std::chrono::system_clock::duration;
+
+    enum Flags : uint8_t
+    {
+        kRecurring = 1 << 0,
+    };
+
+private:
+    // Struct-of-arrays: index i of every vector describes the same event.
+    struct Chunk
+    {
+        std::vector<TimePoint> starts;
+        std::vector<Duration> durations;
+        std::vector<uint8_t> flags;
+        std::vector<InternPool::Handle> categoryIds;
+        std::vector<EventPtr> events; // cold side: text lives in the Event
+
+        size_t size() const { return starts.size(); }
+        void insertAt(size_t pos, EventPtr event);
+        void eraseAt(size_t pos);
+        void setAt(size_t pos, EventPtr event);
+        void append(const Chunk &other, size_t from);
+        void eraseRange(size_t from, size_t to);
+        void truncate(size_t n);
+    };
+    using ChunkList = std::vector<std::shared_ptr<Chunk>>;
+
+public:
+    // Chunks split when they grow past kMaxChunk and are merged with a
+    // neighbour when they shrink below kMinChunk.
+    static constexpr size_t kMaxChunk = 512;
+    static constexpr size_t kMinChunk = 64;
+
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = EventPtr;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const EventPtr *;
+        using reference = const EventPtr &;
+
+        const_iterator() = default;
+        reference operator*() const { return (*chunks_)[chunk_]->events[pos_]; }
+        pointer operator->() const { return &**this; }
+
+        // Hot fields, read without touching the Event
+        TimePoint start() const { return (*chunks_)[chunk_]->starts[pos_]; }
+        Duration duration() const { return (*chunks_)[chunk_]->durations[pos_]; }
+        bool isRecurring() const { return ((*chunks_)[chunk_]->flags[pos_] & kRecurring) != 0; }
+        InternPool::Handle categoryId() const { return (*chunks_)[chunk_]->categoryIds[pos_]; }
+
+        const_iterator &operator++()
+        {
+            if (++pos_ == (*chunks_)[chunk_]->size())
+            {
+                ++chunk_;
+                pos_ = 0;
+            }
+            return *this;
+        }
+        const_iterator operator++(int)
+        {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+        bool operator==(const const_iterator &o) const { return chunk_ == o.chunk_ && pos_ == o.pos_; }
+        bool operator!=(const const_iterator &o) const { return !(*this == o); }
+
+    private:
+        friend class EventSnapshot;
+        const_iterator(const ChunkList *chunks, size_t chunk, size_t pos)
+            : chunks_(chunks), chunk_(chunk), pos_(pos) {}
+        const ChunkList *chunks_ = nullptr;
+        size_t chunk_ = 0;
+        size_t pos_ = 0;
+    };
+
+    EventSnapshot() = default;
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    const_iterator begin() const { return const_iterator(&chunks_, 0, 0); }
+    const_iterator end() const { return const_iterator(&chunks_, chunks_.size(), 0); }
+
+    // First event starting at or after `t`
+    const_iterator lowerBound(TimePoint t) const;
+    // First event starting strictly after `t`
+    const_iterator upperBound(TimePoint t) const;
+
+    // Accumulates edits against a base snapshot and publishes them as a new one.
+    class Builder
+    {
+    public:
+        explicit Builder(const std::shared_ptr<const EventSnapshot> &base);
+
+        // Insert after any events with the same start time.
+        void insert(EventPtr event);
+        // Remove `event` (matched by identity). Returns false if absent.
+        bool erase(const Event *event);
+        // Swap `current` for `next` in place. Both must start at the same time.
+        bool replace(const Event *current, EventPtr next);
+        // Remove every event starting in [start, end). Chunks wholly inside
+        // the range are dropped without being copied. Returns the count.
+        size_t eraseRange(TimePoint start, TimePoint end);
+        void clear();
+
+        std::shared_ptr<const EventSnapshot> build();
+
+    private:
+        ChunkList chunks_;
+        std::vector<bool> owned_; // chunks already copied for this builder
+        size_t size_ = 0;
+
+        Chunk &mutableChunk(size_t index);
+        bool locate(const Event *event, size_t &chunk, size_t &pos) const;
+        void rebalance(size_t index);
+    };
+
+private:
+    ChunkList chunks_;
+    size_t size_ = 0;
+
+    template <typename Before>
+    const_iterator bound(TimePoint t, Before before) const;
+};
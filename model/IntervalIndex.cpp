@@ -0,0 +1,157 @@
+#include "IntervalIndex.h"
+#include <algorithm>
+#include <vector>
+
+IntervalIndex::IntervalIndex() : rng_(std::random_device{}()) {}
+
+IntervalIndex::~IntervalIndex()
+{
+    clear();
+}
+
+void IntervalIndex::insert(const Event *event, TimePoint start, TimePoint end)
+{
+    auto fresh = std::make_unique<Node>();
+    fresh->start = start;
+    fresh->end = end;
+    fresh->maxEnd = end;
+    fresh->seq = nextSeq_++;
+    fresh->priority = rng_();
+    fresh->event = event;
+    insertNode(root_, std::move(fresh));
+    ++size_;
+}
+
+bool IntervalIndex::erase(const Event *event, TimePoint start)
+{
+    if (!eraseNode(root_, event, start))
+        return false;
+    --size_;
+    return true;
+}
+
+void IntervalIndex::clear()
+{
+    // Tear down iteratively so a degenerate tree cannot overflow the stack
+    std::vector<std::unique_ptr<Node>> pending;
+    if (root_)
+        pending.push_back(std::move(root_));
+    while (!pending.empty())
+    {
+        auto node = std::move(pending.back());
+        pending.pop_back();
+        if (node->left)
+            pending.push_back(std::move(node->left));
+        if (node->right)
+            pending.push_back(std::move(node->right));
+    }
+    size_ = 0;
+}
+
+void IntervalIndex::update(Node *n)
+{
+    n->maxEnd = n->end;
+    if (n->left)
+        n->maxEnd = std::max(n->maxEnd, n->left->maxEnd);
+    if (n->right)
+        n->maxEnd = std::max(n->maxEnd, n->right->maxEnd);
+}
+
+bool IntervalIndex::keyLess(const Node &a, const Node &b)
+{
+    if (a.start != b.start)
+        return a.start < b.start;
+    return a.seq < b.seq;
+}
+
+void IntervalIndex::split(std::unique_ptr<Node> node, const Node &key,
+                          std::unique_ptr<Node> &left, std::unique_ptr<Node> &right)
+{
+    if (!node)
+    {
+        left.reset();
+        right.reset();
+        return;
+    }
+    if (keyLess(*node, key))
+    {
+        split(std::move(node->right), key, node->right, right);
+        update(node.get());
+        left = std::move(node);
+    }
+    else
+    {
+        split(std::move(node->left), key, left, node->left);
+        update(node.get());
+        right = std::move(node);
+    }
+}
+
+std::unique_ptr<IntervalIndex::Node> IntervalIndex::merge(std::unique_ptr<Node> left,
+                                                          std::unique_ptr<Node> right)
+{
+    if (!left)
+        return right;
+    if (!right)
+        return left;
+    if (left->priority > right->priority)
+    {
+        left->right = merge(std::move(left->right), std::move(right));
+        update(left.get());
+        return left;
+    }
+    right->left = merge(std::move(left), std::move(right->left));
+    update(right.get());
+    return right;
+}
+
+void IntervalIndex::insertNode(std::unique_ptr<Node> &node, std::unique_ptr<Node> fresh)
+{
+    if (!node)
+    {
+        node = std::move(fresh);
+        return;
+    }
+    if (fresh->priority > node->priority)
+    {
+        split(std::move(node), *fresh, fresh->left, fresh->right);
+        update(fresh.get());
+        node = std::move(fresh);
+        return;
+    }
+    if (keyLess(*fresh, *node))
+        insertNode(node->left, std::move(fresh));
+    else
+        insertNode(node->right, std::move(fresh));
+    update(node.get());
+}
+
+bool IntervalIndex::eraseNode(std::unique_ptr<Node> &node, const Event *event, TimePoint start)
+{
+    if (!node)
+        return false;
+
+    bool found;
+    if (start < node->start)
+    {
+        found = eraseNode(node->left, event, start);
+    }
+    else if (node->start < start)
+    {
+        found = eraseNode(node->right, event, start);
+    }
+    else if (node->event == event)
+    {
+        node = merge(std::move(node->left), std::move(node->right));
+        return true;
+    }
+    else
+    {
+        // Equal starts are ordered by insertion, so the match may be on either side
+        found = eraseNode(node->left, event, start) || eraseNode(node->right, event, start);
+    }
+
+    if (found)
+        update(node.get());
+    return found;
+}
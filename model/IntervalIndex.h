@@ -0,0 +1,84 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+
+class Event;
+
+/*
+  Augmented interval treap used for conflict detection.
+  Nodes are ordered by start time and every node caches the largest end time
+  found in its subtree, so an overlap query can skip any subtree that finishes
+  before the window opens. "What overlaps [start, end)" costs O(log n + k).
+  Intervals are half-open and identified by the Event they describe.
+*/
+class IntervalIndex
+{
+public:
+    using TimePoint = std::chrono::system_clock::time_point;
+
+    IntervalIndex();
+    ~IntervalIndex();
+    IntervalIndex(const IntervalIndex &) = delete;
+    IntervalIndex &operator=(const IntervalIndex &) = delete;
+
+    void insert(const Event *event, TimePoint start, TimePoint end);
+
+    // Remove the interval registered for `event` at `start`. Returns false if absent.
+    bool erase(const Event *event, TimePoint start);
+
+    void clear();
+    size_t size() const { return size_; }
+
+    // Call visit(event) for every interval overlapping [start, end), in start
+    // order (insertion order for equal starts). Returning false stops the walk.
+    template <typename Visitor>
+    void forEachOverlap(TimePoint start, TimePoint end, Visitor &&visit) const
+    {
+        walk(root_.get(), start, end, visit);
+    }
+
+private:
+    struct Node
+    {
+        TimePoint start;
+        TimePoint end;
+        TimePoint maxEnd;
+        uint64_t seq;
+        uint32_t priority;
+        const Event *event;
+        std::unique_ptr<Node> left;
+        std::unique_ptr<Node> right;
+    };
+
+    std::unique_ptr<Node> root_;
+    size_t size_ = 0;
+    uint64_t nextSeq_ = 0;
+    std::mt19937 rng_;
+
+    static void update(Node *n);
+    static bool keyLess(const Node &a, const Node &b);
+    static void split(std::unique_ptr<Node> node, const Node &key,
+                      std::unique_ptr<Node> &left, std::unique_ptr<Node> &right);
+    static std::unique_ptr<Node> merge(std::unique_ptr<Node> left, std::unique_ptr<Node> right);
+    static void insertNode(std::unique_ptr<Node> &node, std::unique_ptr<Node> fresh);
+    static bool eraseNode(std::unique_ptr<Node> &node, const Event *event, TimePoint start);
+
+    template <typename Visitor>
+    static bool walk(const Node *n, TimePoint start, TimePoint end, Visitor &visit)
+    {
+        if (!n || n->maxEnd <= start)
+            return true;
+        if (!walk(n->left.get(), start, end, visit))
+            return false;
+        // Everything to the right starts at or after this node
+        if (n->start >= end)
+            return true;
+        if (n->end > start && !visit(*n->event))
+            return false;
+        return walk(n->right.get(), start, end, visit);
+    }
+};
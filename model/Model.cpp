@@ -3,101 +3,412 @@
 #include "RecurringEvent.h"
 #include <algorithm>
 #include <stdexcept>
-#include <random>
-#include <sstream>
 #include <memory>
 #include <cctype>
-#include <regex>
 #include <vector>
 #include <string>
 #include <iostream>
 #include <cstdlib>
+#include <limits>
+#include <unordered_set>
+#include <future>
+#include <iterator>
 #include "../utils/Logger.h"
+#include "../utils/IdGenerator.h"
+#include "../utils/ThreadPool.h"
 
-// Helper utilities for fuzzy searching
 namespace
 {
-    std::string toLowerCopy(std::string s)
+    std::vector<Event> materializeAll(const std::vector<Occurrence> &occurrences)
     {
-        std::transform(s.begin(), s.end(), s.begin(), ::tolower);
-        return s;
+        std::vector<Event> result;
+        result.reserve(occurrences.size());
+        for (const auto &o : occurrences)
+            result.push_back(o.materialize());
+        return result;
     }
 
-    int levenshteinDistance(const std::string &s1, const std::string &s2)
+    bool startsBefore(const Occurrence &a, const Occurrence &b)
     {
-        const size_t len1 = s1.size(), len2 = s2.size();
-        std::vector<int> col(len2 + 1), prevCol(len2 + 1);
-
-        for (size_t i = 0; i <= len2; ++i)
-            prevCol[i] = static_cast<int>(i);
+        return a.start < b.start;
+    }
 
-        for (size_t i = 0; i < len1; ++i)
-        {
-            col[0] = static_cast<int>(i + 1);
-            for (size_t j = 0; j < len2; ++j)
-                col[j + 1] = std::min({prevCol[j + 1] + 1,
-                                       col[j] + 1,
-                                       prevCol[j] + (s1[i] == s2[j] ? 0 : 1)});
-            prevCol.swap(col);
-        }
-        return prevCol[len2];
+    // Value results for the copying query API
+    std::vector<Event> copyOut(const std::vector<std::shared_ptr<const Event>> &events)
+    {
+        std::vector<Event> result;
+        result.reserve(events.size());
+        for (const auto &e : events)
+            result.push_back(*e);
+        return result;
     }
 
-    double similarityRatio(const std::string &a, const std::string &b)
+    // Run `writes` as one transaction: commit if it returns true, roll
+    // everything back otherwise. Stores without transactions get the writes
+    // applied one by one, so `writes` should stop at the first failure.
+    template <typename Writes>
+    bool writeAtomically(IScheduleDatabase &db, Writes &&writes)
     {
-        int dist = levenshteinDistance(a, b);
-        int maxLen = static_cast<int>(std::max(a.size(), b.size()));
-        if (maxLen == 0)
-            return 1.0;
-        return 1.0 - static_cast<double>(dist) / static_cast<double>(maxLen);
+        bool inTransaction = db.beginTransaction();
+        bool ok = writes();
+        if (!inTransaction)
+            return ok;
+        if (ok && db.commitTransaction())
+            return true;
+        db.rollbackTransaction();
+        return false;
     }
 } // namespace
 
 bool Model::eventExists(const std::string &id) const
 {
-    return std::any_of(events.begin(), events.end(), [&](const auto &pair)
-                       { return pair.second->getId() == id; });
+    return idIndex_.count(id) != 0;
 }
 
-std::string Model::generateUniqueId() const
+std::shared_ptr<const EventSnapshot> Model::snapshot() const
 {
-    static std::mt19937_64 gen(std::random_device{}());
-    static std::uniform_int_distribution<uint64_t> dist;
-    std::string id;
-    std::lock_guard<std::mutex> lock(mutex_);
-    do
+    return std::atomic_load(&snapshot_);
+}
+
+void Model::publishLocked(EventSnapshot::Builder &draft)
+{
+    std::atomic_store(&snapshot_, draft.build());
+}
+
+void Model::insertLocked(EventSnapshot::Builder &draft, EventPtr e)
+{
+    changes_.record(ChangeLog::Kind::Upsert, e->getId());
+    admitLocked(draft, std::move(e));
+}
+
+void Model::admitLocked(EventSnapshot::Builder &draft, EventPtr e)
+{
+    indexLocked(e);
+    draft.insert(std::move(e));
+}
+
+void Model::eraseLocked(EventSnapshot::Builder &draft, EventPtr e)
+{
+    changes_.record(ChangeLog::Kind::Delete, e->getId());
+    unindexLocked(e);
+    draft.erase(e.get());
+}
+
+void Model::replaceLocked(EventSnapshot::Builder &draft, const EventPtr &current, EventPtr next)
+{
+    if (current->getId() != next->getId())
+        changes_.record(ChangeLog::Kind::Delete, current->getId());
+    changes_.record(ChangeLog::Kind::Upsert, next->getId());
+    unindexLocked(current);
+    indexLocked(next);
+    // Same start time keeps the slot; otherwise it has to move
+    if (current->getTime() != next->getTime() || !draft.replace(current.get(), next))
     {
-        std::stringstream ss;
-        ss << std::hex << dist(gen);
-        id = ss.str();
-    } while (eventExists(id));
-    return id;
+        draft.erase(current.get());
+        draft.insert(std::move(next));
+    }
+}
+
+void Model::indexLocked(const EventPtr &e)
+{
+    idIndex_[e->getId()] = e;
+    auto span = conflictSpan(*e);
+    intervals_.insert(e.get(), span.first, span.second);
+    if (e->isRecurring())
+    {
+        // Runs one tick past the busy span so a zero-length last occurrence
+        // still overlaps a window starting at it
+        auto last = span.second == std::chrono::system_clock::time_point::max()
+                        ? span.second
+                        : span.second + std::chrono::system_clock::duration(1);
+        seriesSpans_.insert(e.get(), span.first, last);
+    }
+    categoryIndex_[e->getCategory()].insert(e);
+    searchIndex_.insert(e.get());
+    if (!e->isRecurring())
+        longest_ = std::max(longest_, e->getDuration());
+}
+
+void Model::unindexLocked(const EventPtr &e)
+{
+    searchIndex_.erase(e.get());
+    auto list = categoryIndex_.find(e->getCategory());
+    if (list != categoryIndex_.end())
+    {
+        list->second.erase(e);
+        // Categories exist only while something is filed under them
+        if (list->second.empty())
+            categoryIndex_.erase(list);
+    }
+    intervals_.erase(e.get(), e->getTime());
+    if (e->isRecurring())
+        seriesSpans_.erase(e.get(), e->getTime());
+    idIndex_.erase(e->getId());
+}
+
+bool Model::PostingOrder::operator()(const EventPtr &a, const EventPtr &b) const
+{
+    if (a->getTime() != b->getTime())
+        return a->getTime() < b->getTime();
+    return a->getId() < b->getId();
+}
+
+std::pair<std::chrono::system_clock::time_point, std::chrono::system_clock::time_point>
+Model::conflictSpan(const Event &e)
+{
+    auto start = e.getTime();
+    auto last = start;
+    if (e.isRecurring())
+    {
+        const auto *re = dynamic_cast<const RecurringEvent *>(&e);
+        if (re && re->getRecurrencePattern())
+            last = std::max(start, re->getRecurrencePattern()->lastOccurrenceBound());
+    }
+    // Unbounded series stay open-ended rather than overflowing the clock;
+    // so do end dates stored as whole seconds just short of the maximum
+    if (last > std::chrono::system_clock::time_point::max() - e.getDuration())
+        return {start, std::chrono::system_clock::time_point::max()};
+    return {start, last + e.getDuration()};
+}
+
+void Model::collectConflictsLocked(std::chrono::system_clock::time_point start,
+                                   std::chrono::system_clock::time_point end,
+                                   size_t limit,
+                                   std::vector<Event> &out) const
+{
+    intervals_.forEachOverlap(start, end, [&](const Event &event)
+                              {
+        const auto *re = event.isRecurring() ? dynamic_cast<const RecurringEvent *>(&event) : nullptr;
+        if (!re || !re->getRecurrencePattern())
+        {
+            out.push_back(event);
+            return out.size() < limit;
+        }
+
+        // The series span overlaps; report the individual occurrences that do,
+        // starting with any still running at `start`
+        auto from = start - re->getDuration() + std::chrono::system_clock::duration(1);
+        for (auto t : re->occurrencesBetween(from, end))
+        {
+            auto occurrence = re->clone();
+            occurrence->setTime(t);
+            out.push_back(*occurrence);
+            if (out.size() >= limit)
+                return false;
+        }
+        return true; });
+}
+
+uint16_t Model::changedFields(const Event &before, const Event &after)
+{
+    // A series may carry a new recurrence, which no field bit covers
+    if (before.isRecurring() || after.isRecurring())
+        return Event::kAllFields;
+    uint16_t fields = 0;
+    if (before.getDescription() != after.getDescription()) fields |= Event::kDescription;
+    if (before.getTitle() != after.getTitle()) fields |= Event::kTitle;
+    if (before.getTime() != after.getTime()) fields |= Event::kTime;
+    if (before.getDuration() != after.getDuration()) fields |= Event::kDuration;
+    if (before.getCategoryHandle() != after.getCategoryHandle()) fields |= Event::kCategory;
+    if (before.getProviderEventId() != after.getProviderEventId()) fields |= Event::kProviderEventId;
+    if (before.getProviderTaskId() != after.getProviderTaskId()) fields |= Event::kProviderTaskId;
+    if (before.getNotifierHandle() != after.getNotifierHandle()) fields |= Event::kNotifier;
+    if (before.getActionHandle() != after.getActionHandle()) fields |= Event::kAction;
+    return fields;
+}
+
+std::string Model::generateUniqueId() const
+{
+    return IdGenerator::next();
 }
 
 Model::Model(IScheduleDatabase *db, int preloadDaysAhead)
-    : db_(db)
+    : db_(db), paging_(db != nullptr && preloadDaysAhead >= 0)
 {
-    if (preloadDaysAhead < 0)
-        preloadEnd_ = std::chrono::system_clock::time_point::max();
-    else
-        preloadEnd_ = std::chrono::system_clock::now() +
-                      std::chrono::hours(24 * preloadDaysAhead);
+    EventSnapshot::Builder draft(nullptr);
+    if (paging_)
+    {
+        auto now = std::chrono::system_clock::now();
+        auto window = std::chrono::hours(24 * preloadDaysAhead);
+        longest_ = db_->getLongestDuration();
+        for (auto &e : db_->getRecurringEvents())
+            admitLocked(draft, std::move(e));
+        for (auto &e : db_->getEventsInRange(now - window, now + window, 0))
+            admitLocked(draft, std::move(e));
+        loaded_.emplace(now - window, now + window);
+    }
+    else if (db_)
+    {
+        for (auto &e : db_->getAllEvents())
+            admitLocked(draft, std::move(e));
+    }
+    publishLocked(draft);
 
-    if (db_)
+    if (db_ && db_->storesTombstones())
     {
-        auto loaded = db_->getAllEvents();
-        for (auto &e : loaded)
+        diskTombstones_ = true;
+        for (auto &entry : db_->getTombstoneIds())
         {
-            if (preloadDaysAhead >= 0 && e->getTime() > preloadEnd_)
-                continue;
-            // Track categories for loaded events
-            if (!e->getCategory().empty())
-            {
-                categories_.insert(e->getCategory());
-            }
-            events.emplace(e->getTime(), std::move(e));
+            auto order = tombstoneOrder_.emplace(entry.second, entry.first);
+            tombstones_[entry.first] = Tombstone{order, nullptr};
         }
+        compactTombstonesLocked(std::chrono::system_clock::now());
+    }
+}
+
+// ===== Paging =====
+
+namespace
+{
+    // Smallest time after `t`, for turning inclusive bounds into [start, end)
+    std::chrono::system_clock::time_point justAfter(std::chrono::system_clock::time_point t)
+    {
+        if (t == std::chrono::system_clock::time_point::max())
+            return t;
+        return t + std::chrono::system_clock::duration(1);
+    }
+} // namespace
+
+void Model::faultIn(std::chrono::system_clock::time_point start,
+                    std::chrono::system_clock::time_point end) const
+{
+    if (!paging_ || !(start < end))
+        return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &gap : unloadedGapsLocked(start, end))
+    {
+        loadLocked(db_->getEventsInRange(gap.first, gap.second, 0));
+        markLoadedLocked(gap.first, gap.second);
+    }
+}
+
+std::vector<std::pair<std::chrono::system_clock::time_point, std::chrono::system_clock::time_point>>
+Model::unloadedGapsLocked(std::chrono::system_clock::time_point start,
+                          std::chrono::system_clock::time_point end) const
+{
+    std::vector<std::pair<std::chrono::system_clock::time_point, std::chrono::system_clock::time_point>> gaps;
+    if (!paging_)
+        return gaps;
+    auto cursor = start;
+    auto it = loaded_.upper_bound(start);
+    if (it != loaded_.begin() && std::prev(it)->second > cursor)
+        cursor = std::prev(it)->second;
+    while (cursor < end)
+    {
+        if (it == loaded_.end() || !(it->first < end))
+        {
+            gaps.emplace_back(cursor, end);
+            break;
+        }
+        if (cursor < it->first)
+            gaps.emplace_back(cursor, it->first);
+        cursor = std::max(cursor, it->second);
+        ++it;
+    }
+    return gaps;
+}
+
+void Model::faultInOverlapping(std::chrono::system_clock::time_point start,
+                               std::chrono::system_clock::time_point end) const
+{
+    if (!paging_)
+        return;
+    std::chrono::system_clock::duration longest;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        longest = longest_;
+    }
+    auto earliest = std::chrono::system_clock::time_point::min();
+    auto from = start < earliest + longest ? earliest : start - longest;
+    faultIn(from, end);
+}
+
+void Model::faultInNext(std::chrono::system_clock::time_point from, size_t n) const
+{
+    if (!paging_ || n == 0)
+        return;
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Events before the first uncovered point are resident already
+    auto cursor = from;
+    auto it = loaded_.upper_bound(from);
+    if (it != loaded_.begin() && std::prev(it)->second > cursor)
+        cursor = std::prev(it)->second;
+    if (cursor == std::chrono::system_clock::time_point::max())
+        return;
+
+    auto rows = db_->getEventsInRange(cursor, std::chrono::system_clock::time_point::max(), n);
+    // Fewer than n rows means nothing is left beyond them. Otherwise
+    // everything before the last row is now known; rows tied with it may
+    // not all have come back, so its instant stays uncovered.
+    auto reached = rows.size() < n ? std::chrono::system_clock::time_point::max() : rows.back()->getTime();
+    loadLocked(std::move(rows));
+    if (cursor < reached)
+        markLoadedLocked(cursor, reached);
+}
+
+void Model::faultInId(const std::string &id) const
+{
+    if (!paging_)
+        return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (eventExists(id) || (!diskTombstones_ && tombstones_.count(id)))
+        return;
+    auto e = db_->getEventById(id);
+    if (!e)
+        return;
+    std::vector<std::unique_ptr<Event>> rows;
+    rows.push_back(std::move(e));
+    loadLocked(std::move(rows));
+}
+
+void Model::loadLocked(std::vector<std::unique_ptr<Event>> rows) const
+{
+    if (rows.empty())
+        return;
+    // Loading changes what is resident, not what the model holds, so const
+    // queries are allowed to do it
+    auto &self = const_cast<Model &>(*this);
+    std::unique_lock<std::shared_mutex> index(indexMutex_);
+    EventSnapshot::Builder draft(snapshot_);
+    bool changed = false;
+    for (auto &e : rows)
+    {
+        // Rows added or edited here are resident already, and soft-deleted
+        // ones must stay out until restored (a tombstone store takes them
+        // out of the table itself)
+        if (eventExists(e->getId()) || (!diskTombstones_ && tombstones_.count(e->getId())))
+            continue;
+        self.admitLocked(draft, std::move(e));
+        changed = true;
+    }
+    if (changed)
+        self.publishLocked(draft);
+}
+
+void Model::markLoadedLocked(std::chrono::system_clock::time_point start,
+                             std::chrono::system_clock::time_point end) const
+{
+    // Merge with every span that touches [start, end)
+    auto it = loaded_.upper_bound(start);
+    if (it != loaded_.begin() && !(std::prev(it)->second < start))
+    {
+        --it;
+        start = it->first;
+        end = std::max(end, it->second);
+        it = loaded_.erase(it);
     }
+    while (it != loaded_.end() && !(end < it->first))
+    {
+        end = std::max(end, it->second);
+        it = loaded_.erase(it);
+    }
+    loaded_.emplace(start, end);
+}
+
+bool Model::flush()
+{
+    return !db_ || db_->flush();
 }
 
 void Model::addCalendarApi(std::shared_ptr<CalendarApi> api)
@@ -110,19 +421,27 @@ std::vector<Event>
 Model::getEvents(int maxOccurrences,
                  std::chrono::system_clock::time_point endDate) const
 {
-    std::vector<Event> result;
-    std::lock_guard<std::mutex> lock(mutex_);
-    result.reserve(events.size());
+    return copyOut(getEventPtrs(maxOccurrences, endDate));
+}
 
+std::vector<Model::EventPtr>
+Model::getEventPtrs(int maxOccurrences,
+                    std::chrono::system_clock::time_point endDate) const
+{
+    if (maxOccurrences > 0)
+        faultInNext(std::chrono::system_clock::time_point::min(), static_cast<size_t>(maxOccurrences));
+    else
+        faultIn(std::chrono::system_clock::time_point::min(), justAfter(endDate));
+    std::vector<EventPtr> result;
+    auto snap = snapshot();
 
-    for (const auto &kv : events)
+    for (auto it = snap->begin(); it != snap->end(); ++it)
     {
-        const Event &e = *kv.second;
-        if (e.getTime() > endDate)
+        if (it.start() > endDate)
         {
             break;
         }
-        result.push_back(e);
+        result.push_back(*it);
         if (maxOccurrences > 0 && static_cast<int>(result.size()) >= maxOccurrences)
         {
             break;
@@ -133,49 +452,89 @@ Model::getEvents(int maxOccurrences,
 
 std::vector<Event> Model::getNextNEvents(int n) const
 {
-    std::vector<Event> occurrences;
+    return materializeAll(getNextOccurrences(n));
+}
+
+std::vector<Occurrence> Model::getNextOccurrences(int n) const
+{
+    std::vector<Occurrence> occurrences;
     if (n <= 0)
         return occurrences;
 
     auto now = std::chrono::system_clock::now();
-    auto start = now - std::chrono::seconds(1);
+    auto from = justAfter(now - std::chrono::seconds(1));
+    faultInNext(justAfter(now), static_cast<size_t>(n));
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (events.empty())
-        return occurrences;
+    // Series still running after `from`, with the matching snapshot
+    std::shared_ptr<const EventSnapshot> snap;
+    std::vector<EventPtr> series;
+    {
+        std::shared_lock<std::shared_mutex> lock(indexMutex_);
+        snap = snapshot();
+        seriesSpans_.forEachOverlap(from, std::chrono::system_clock::time_point::max(), [&](const Event &event)
+                                    {
+            auto found = idIndex_.find(event.getId());
+            if (found != idIndex_.end())
+                series.push_back(found->second);
+            return true; });
+    }
+
+    // One lazy stream per series, merged through a min-heap on the next
+    // start; ties go to the series that starts first
+    struct Stream
+    {
+        std::chrono::system_clock::time_point next;
+        size_t order;
+        std::unique_ptr<OccurrenceCursor> cursor;
+        uint32_t index;
+    };
+    auto later = [](const Stream &a, const Stream &b)
+    {
+        return a.next != b.next ? a.next > b.next : a.order > b.order;
+    };
+    std::vector<Stream> heap;
+    heap.reserve(series.size());
+    for (size_t i = 0; i < series.size(); ++i)
+    {
+        const auto *re = dynamic_cast<const RecurringEvent *>(series[i].get());
+        if (!re || !re->getRecurrencePattern())
+            continue;
+        Stream stream{{}, i, re->getRecurrencePattern()->occurrencesFrom(from), 0};
+        if (stream.cursor->next(stream.next))
+            heap.push_back(std::move(stream));
+    }
+    std::make_heap(heap.begin(), heap.end(), later);
 
-    for (const auto &kv : events)
+    // One-time events are already in start order, from just after now
+    auto single = snap->upperBound(now);
+    auto skipSeries = [&]
     {
-        const Event &e = *kv.second;
-        if (!e.isRecurring())
+        while (single != snap->end() && single.isRecurring())
+            ++single;
+    };
+    skipSeries();
+
+    occurrences.reserve(static_cast<size_t>(n));
+    while (static_cast<int>(occurrences.size()) < n)
+    {
+        bool haveSingle = single != snap->end();
+        if (!haveSingle && heap.empty())
+            break;
+        if (haveSingle && (heap.empty() || single.start() <= heap.front().next))
         {
-            if (e.getTime() > now)
-            {
-                occurrences.push_back(e);
-            }
+            occurrences.push_back({*single, single.start(), 0});
+            ++single;
+            skipSeries();
+            continue;
         }
+        std::pop_heap(heap.begin(), heap.end(), later);
+        auto &stream = heap.back();
+        occurrences.push_back({series[stream.order], stream.next, stream.index++});
+        if (stream.cursor->next(stream.next))
+            std::push_heap(heap.begin(), heap.end(), later);
         else
-        {
-            const auto *re = dynamic_cast<const RecurringEvent *>(kv.second.get());
-            if (!re)
-                continue;
-
-            auto times = re->getNextNOccurrences(start, n);
-            for (auto t : times)
-            {
-                RecurringEvent occ(re->getId(), re->getDescription(), re->getTitle(),
-                                   t, re->getDuration(), re->getRecurrencePattern());
-                occurrences.push_back(occ);
-            }
-        }
+            heap.pop_back();
     }
-
-    std::sort(occurrences.begin(), occurrences.end(),
-              [](const Event &a, const Event &b)
-              { return a.getTime() < b.getTime(); });
-
-    if (static_cast<int>(occurrences.size()) > n)
-        occurrences.erase(occurrences.begin() + n, occurrences.end());
     return occurrences;
 }
 
@@ -191,6 +550,7 @@ Event Model::getNextEvent() const
 
 bool Model::addEvent(const Event &e)
 {
+    faultInId(e.getId());
     std::vector<std::shared_ptr<CalendarApi>> apisCopy;
     {
         std::lock_guard<std::mutex> lock(mutex_);
@@ -198,13 +558,11 @@ bool Model::addEvent(const Event &e)
         {
             return false;
         }
-        events.emplace(e.getTime(), e.clone());
-
-        // Track category if event has one
-        std::string category = e.getCategory();
-        if (!category.empty())
         {
-            categories_.insert(category);
+            std::unique_lock<std::shared_mutex> index(indexMutex_);
+            EventSnapshot::Builder draft(snapshot_);
+            insertLocked(draft, e.clone());
+            publishLocked(draft);
         }
 
         if (db_)
@@ -241,15 +599,30 @@ bool Model::addEvent(const Event &e)
 
 void Model::removeAllEvents()
 {
-    std::vector<std::unique_ptr<Event>> removed;
+    std::shared_ptr<const EventSnapshot> removed;
     std::vector<std::shared_ptr<CalendarApi>> apisCopy;
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        for (auto &kv : events)
-            removed.push_back(kv.second->clone());
-
-        events.clear();
-        categories_.clear();
+        removed = snapshot_;
+        {
+            std::unique_lock<std::shared_mutex> index(indexMutex_);
+            EventSnapshot::Builder draft(nullptr);
+            publishLocked(draft);
+            idIndex_.clear();
+            intervals_.clear();
+            seriesSpans_.clear();
+            categoryIndex_.clear();
+            searchIndex_.clear();
+            // Too many deletes to list; clients behind this resync
+            changes_.reset();
+        }
+        // The table is about to be empty, so nothing is left to fault in
+        if (paging_)
+        {
+            loaded_.clear();
+            loaded_.emplace(std::chrono::system_clock::time_point::min(),
+                            std::chrono::system_clock::time_point::max());
+        }
         if (db_)
         {
             db_->removeAllEvents();
@@ -258,7 +631,7 @@ void Model::removeAllEvents()
     }
 
     // Notify all calendar APIs
-    for (const auto &e : removed)
+    for (const auto &e : *removed)
     {
         for (auto &api : apisCopy)
         {
@@ -294,49 +667,9 @@ static std::chrono::system_clock::time_point startOfLocalDay(std::chrono::system
     return std::chrono::system_clock::from_time_t(start_t);
 }
 
-std::vector<Event> Model::getEventsOnDay(std::chrono::system_clock::time_point day) const
-{
-    auto start = startOfLocalDay(day);
-    auto end = start + std::chrono::hours(24);
-    std::vector<Event> result;
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (const auto &kv : events)
-    {
-        const Event &e = *kv.second;
-        if (!e.isRecurring())
-        {
-            if (e.getTime() < start)
-                continue;
-            if (e.getTime() >= end)
-                break;
-            result.push_back(e);
-        }
-        else
-        {
-            const auto *re = dynamic_cast<const RecurringEvent *>(kv.second.get());
-            if (!re)
-                continue;
-            auto times = re->getNextNOccurrences(start - std::chrono::seconds(1), 1000);
-            for (auto t : times)
-            {
-                if (t >= end)
-                    break;
-                if (t >= start)
-                {
-                    RecurringEvent occ(re->getId(), re->getDescription(), re->getTitle(),
-                                       t, re->getDuration(), re->getRecurrencePattern(),
-                                       re->getCategory());
-                    result.push_back(occ);
-                }
-            }
-        }
-    }
-    std::sort(result.begin(), result.end(),
-              [](const Event &a, const Event &b) { return a.getTime() < b.getTime(); });
-    return result;
-}
-
-std::vector<Event> Model::getEventsInWeek(std::chrono::system_clock::time_point day) const
+// [start, end) of the local Monday-to-Sunday week containing `day`
+static std::pair<std::chrono::system_clock::time_point, std::chrono::system_clock::time_point>
+weekWindow(std::chrono::system_clock::time_point day)
 {
     time_t t = std::chrono::system_clock::to_time_t(day);
     std::tm tm_buf;
@@ -348,46 +681,12 @@ std::vector<Event> Model::getEventsInWeek(std::chrono::system_clock::time_point
     int wday = tm_buf.tm_wday; // 0=Sunday
     int diff = (wday + 6) % 7; // days since Monday
     auto start = startOfLocalDay(day) - std::chrono::hours(24 * diff);
-    auto end = start + std::chrono::hours(24 * 7);
-    std::vector<Event> result;
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (const auto &kv : events)
-    {
-        const Event &e = *kv.second;
-        if (!e.isRecurring())
-        {
-            if (e.getTime() < start)
-                continue;
-            if (e.getTime() >= end)
-                break;
-            result.push_back(e);
-        }
-        else
-        {
-            const auto *re = dynamic_cast<const RecurringEvent *>(kv.second.get());
-            if (!re)
-                continue;
-            auto times = re->getNextNOccurrences(start - std::chrono::seconds(1), 1000);
-            for (auto t : times)
-            {
-                if (t >= end)
-                    break;
-                if (t >= start)
-                {
-                    RecurringEvent occ(re->getId(), re->getDescription(), re->getTitle(),
-                                       t, re->getDuration(), re->getRecurrencePattern(),
-                                       re->getCategory());
-                    result.push_back(occ);
-                }
-            }
-        }
-    }
-    std::sort(result.begin(), result.end(),
-              [](const Event &a, const Event &b) { return a.getTime() < b.getTime(); });
-    return result;
+    return {start, start + std::chrono::hours(24 * 7)};
 }
 
-std::vector<Event> Model::getEventsInMonth(std::chrono::system_clock::time_point day) const
+// [start, end) of the local calendar month containing `day`
+static std::pair<std::chrono::system_clock::time_point, std::chrono::system_clock::time_point>
+monthWindow(std::chrono::system_clock::time_point day)
 {
     time_t t = std::chrono::system_clock::to_time_t(day);
     std::tm tm_buf;
@@ -400,273 +699,172 @@ std::vector<Event> Model::getEventsInMonth(std::chrono::system_clock::time_point
     tm_buf.tm_hour = 0;
     tm_buf.tm_min = 0;
     tm_buf.tm_sec = 0;
-#if defined(_MSC_VER)
-    time_t start_t = mktime(&tm_buf);
-#else
     time_t start_t = mktime(&tm_buf);
-#endif
-    auto start = std::chrono::system_clock::from_time_t(start_t);
     tm_buf.tm_mon += 1;
-#if defined(_MSC_VER)
-    time_t end_t = mktime(&tm_buf);
-#else
     time_t end_t = mktime(&tm_buf);
-#endif
-    auto end = std::chrono::system_clock::from_time_t(end_t);
+    return {std::chrono::system_clock::from_time_t(start_t),
+            std::chrono::system_clock::from_time_t(end_t)};
+}
 
-    std::vector<Event> result;
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (const auto &kv : events)
-    {
-        const Event &e = *kv.second;
-        if (!e.isRecurring())
-        {
-            if (e.getTime() < start)
-                continue;
-            if (e.getTime() >= end)
-                break;
-            result.push_back(e);
-        }
-        else
-        {
-            const auto *re = dynamic_cast<const RecurringEvent *>(kv.second.get());
-            if (!re)
-                continue;
-            auto times = re->getNextNOccurrences(start - std::chrono::seconds(1), 1000);
-            for (auto t : times)
-            {
-                if (t >= end)
-                    break;
-                if (t >= start)
-                {
-                    RecurringEvent occ(re->getId(), re->getDescription(), re->getTitle(),
-                                       t, re->getDuration(), re->getRecurrencePattern(),
-                                       re->getCategory());
-                    result.push_back(occ);
-                }
-            }
-        }
-    }
-    std::sort(result.begin(), result.end(),
-              [](const Event &a, const Event &b) { return a.getTime() < b.getTime(); });
-    return result;
+std::vector<Event> Model::getEventsOnDay(std::chrono::system_clock::time_point day) const
+{
+    return materializeAll(getOccurrencesOnDay(day));
 }
 
-int Model::removeEventsOnDay(std::chrono::system_clock::time_point day)
+std::vector<Event> Model::getEventsInWeek(std::chrono::system_clock::time_point day) const
+{
+    return materializeAll(getOccurrencesInWeek(day));
+}
+
+std::vector<Event> Model::getEventsInMonth(std::chrono::system_clock::time_point day) const
+{
+    return materializeAll(getOccurrencesInMonth(day));
+}
+
+std::vector<Occurrence> Model::getOccurrencesOnDay(std::chrono::system_clock::time_point day) const
 {
     auto start = startOfLocalDay(day);
-    auto end = start + std::chrono::hours(24);
-    std::vector<std::string> removedIds;
-    std::vector<std::unique_ptr<Event>> removedEvents;
-    std::vector<std::shared_ptr<CalendarApi>> apisCopy;
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        for (auto it = events.begin(); it != events.end();)
-        {
-            auto t = it->second->getTime();
-            if (t >= start && t < end)
-            {
-                removedIds.push_back(it->second->getId());
-                removedEvents.push_back(it->second->clone());
-                it = events.erase(it);
-            }
-            else
-            {
-                ++it;
-            }
-        }
-        if (db_)
-        {
-            for (const auto &id : removedIds)
-                db_->removeEvent(id);
-        }
-        apisCopy = apis_;
-    }
+    return getOccurrencesInRange(start, start + std::chrono::hours(24), 1000);
+}
 
-    // Notify all calendar APIs
-    for (const auto &e : removedEvents)
-    {
-        for (auto &api : apisCopy)
-        {
-            try
-            {
-                api->deleteEvent(*e);
-            }
-            catch (const std::exception &ex)
-            {
-                // Log error but continue
-            }
-        }
-    }
-    return static_cast<int>(removedIds.size());
+std::vector<Occurrence> Model::getOccurrencesInWeek(std::chrono::system_clock::time_point day) const
+{
+    auto window = weekWindow(day);
+    return getOccurrencesInRange(window.first, window.second, 1000);
 }
 
-int Model::removeEventsInWeek(std::chrono::system_clock::time_point day)
+std::vector<Occurrence> Model::getOccurrencesInMonth(std::chrono::system_clock::time_point day) const
 {
-    time_t t = std::chrono::system_clock::to_time_t(day);
-    std::tm tm_buf;
-#if defined(_MSC_VER)
-    localtime_s(&tm_buf, &t);
-#else
-    localtime_r(&t, &tm_buf);
-#endif
-    int wday = tm_buf.tm_wday;
-    int diff = (wday + 6) % 7;
-    auto start = startOfLocalDay(day) - std::chrono::hours(24 * diff);
-    auto end = start + std::chrono::hours(24 * 7);
-    std::vector<std::string> removedIds;
-    std::vector<std::unique_ptr<Event>> removedEvents;
-    std::vector<std::shared_ptr<CalendarApi>> apisCopy;
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        for (auto it = events.begin(); it != events.end();)
-        {
-            auto t2 = it->second->getTime();
-            if (t2 >= start && t2 < end)
-            {
-                removedIds.push_back(it->second->getId());
-                removedEvents.push_back(it->second->clone());
-                it = events.erase(it);
-            }
-            else
-            {
-                ++it;
-            }
-        }
-        if (db_)
-        {
-            for (const auto &id : removedIds)
-                db_->removeEvent(id);
-        }
-        apisCopy = apis_;
-    }
+    auto window = monthWindow(day);
+    return getOccurrencesInRange(window.first, window.second, 1000);
+}
 
-    // Notify all calendar APIs
-    for (const auto &e : removedEvents)
-    {
-        for (auto &api : apisCopy)
-        {
-            try
-            {
-                api->deleteEvent(*e);
-            }
-            catch (const std::exception &ex)
-            {
-                // Log error but continue
-            }
-        }
-    }
-    return static_cast<int>(removedIds.size());
+int Model::removeEventsOnDay(std::chrono::system_clock::time_point day)
+{
+    auto start = startOfLocalDay(day);
+    return removeEventsInRange(start, start + std::chrono::hours(24));
+}
+
+int Model::removeEventsInWeek(std::chrono::system_clock::time_point day)
+{
+    auto window = weekWindow(day);
+    return removeEventsInRange(window.first, window.second);
 }
 
 int Model::removeEventsBefore(std::chrono::system_clock::time_point time)
 {
-    std::vector<std::string> removedIds;
-    std::vector<std::unique_ptr<Event>> removedEvents;
+    return removeEventsInRange(std::chrono::system_clock::time_point::min(), time);
+}
+
+int Model::removeEventsInRange(std::chrono::system_clock::time_point start,
+                               std::chrono::system_clock::time_point end)
+{
+    if (!(start < end))
+        return 0;
+    std::vector<EventPtr> removedEvents;
+    // Stored rows that were never resident; read only for the providers
+    std::vector<std::unique_ptr<Event>> unloaded;
+    size_t unloadedCount = 0;
     std::vector<std::shared_ptr<CalendarApi>> apisCopy;
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        for (auto it = events.begin(); it != events.end();)
+        auto gaps = unloadedGapsLocked(start, end);
+        for (const auto &gap : gaps)
         {
-            if (it->second->getTime() < time)
+            if (apis_.empty())
             {
-                removedIds.push_back(it->second->getId());
-                removedEvents.push_back(it->second->clone());
-                it = events.erase(it);
-            }
-            else
-            {
-                ++it;
+                unloadedCount += db_->countEventsInRange(gap.first, gap.second);
+                continue;
             }
+            for (auto &e : db_->getEventsInRange(gap.first, gap.second, 0))
+                unloaded.push_back(std::move(e));
         }
-        if (db_)
+        unloadedCount += unloaded.size();
+        // The snapshot is time-ordered, so the resident victims are one run
+        for (auto it = snapshot_->lowerBound(start); it != snapshot_->end() && it.start() < end; ++it)
+            removedEvents.push_back(*it);
+        if (removedEvents.empty() && unloadedCount == 0)
+            return 0;
+
+        // Delete from the store first; if that fails nothing is removed
+        if (db_ && !db_->removeEventsInRange(start, end))
+            return 0;
         {
-            for (const auto &id : removedIds)
-                db_->removeEvent(id);
+            std::unique_lock<std::shared_mutex> index(indexMutex_);
+            for (const auto &e : removedEvents)
+            {
+                changes_.record(ChangeLog::Kind::Delete, e->getId());
+                unindexLocked(e);
+            }
+            if (!removedEvents.empty())
+            {
+                EventSnapshot::Builder draft(snapshot_);
+                draft.eraseRange(start, end);
+                publishLocked(draft);
+            }
         }
+        // Nothing is left in the store for this span, so it need not be
+        // faulted in again
+        if (!gaps.empty())
+            markLoadedLocked(start, end);
         apisCopy = apis_;
     }
 
     // Notify all calendar APIs
+    std::vector<const Event *> batch;
+    batch.reserve(removedEvents.size() + unloaded.size());
     for (const auto &e : removedEvents)
+        batch.push_back(e.get());
+    for (const auto &e : unloaded)
+        batch.push_back(e.get());
+    for (auto &api : apisCopy)
     {
-        for (auto &api : apisCopy)
+        try
         {
-            try
-            {
-                api->deleteEvent(*e);
-            }
-            catch (const std::exception &ex)
-            {
-                // Log error but continue
-            }
+            api->deleteEvents(batch);
+        }
+        catch (const std::exception &ex)
+        {
+            // Log error but continue
         }
     }
-    return static_cast<int>(removedIds.size());
+    return static_cast<int>(removedEvents.size() + unloadedCount);
 }
 
 // ====== SEARCH AND QUERY METHODS ======
 
 std::vector<Event> Model::searchEvents(const std::string &query, int maxResults) const
 {
-    // 1) Normalize: lowercase & drop punctuation
-    static const std::regex dropPunct(R"([^a-z0-9\s])");
-    auto normalize = [&](const std::string &s)
-    {
-        std::string lower = toLowerCopy(s);
-        return std::regex_replace(lower, dropPunct, "");
-    };
-
-    // 2) Tokenize helper
-    auto tokenize = [&](const std::string &s)
-    {
-        std::istringstream iss(s);
-        std::vector<std::string> toks;
-        for (std::string w; iss >> w;)
-            toks.push_back(w);
-        return toks;
-    };
-
-    std::string normQuery = normalize(query);
-    auto qToks = tokenize(normQuery);
+    return copyOut(searchEventPtrs(query, maxResults));
+}
 
-    std::vector<Event> results;
-    std::lock_guard<std::mutex> lock(mutex_);
+std::vector<Model::EventPtr> Model::searchEventPtrs(const std::string &query, int maxResults) const
+{
+    faultIn(std::chrono::system_clock::time_point::min(), std::chrono::system_clock::time_point::max());
+    auto qToks = SearchIndex::tokenize(query);
+    std::vector<EventPtr> results;
 
-    for (const auto &kv : events)
+    // No words to match: every event qualifies, in time order
+    if (qToks.empty())
     {
-        const auto &evt = kv.second;
-        std::string combined = evt->getTitle() + " " + evt->getDescription();
-        std::string normCombined = normalize(combined);
-        auto cToks = tokenize(normCombined);
-
-        bool allMatch = true;
-        for (auto &qt : qToks)
+        auto snap = snapshot();
+        for (const auto &evt : *snap)
         {
-            bool found = false;
-            for (auto &ct : cToks)
-            {
-                // exact substring or fuzzy similarity
-                if (ct.find(qt) != std::string::npos || similarityRatio(qt, ct) >= 0.5)
-                {
-                    found = true;
-                    break;
-                }
-            }
-            if (!found)
-            {
-                allMatch = false;
-                break;
-            }
-        }
-
-        if (allMatch)
-        {
-            results.push_back(*evt);
             if (maxResults > 0 && (int)results.size() >= maxResults)
                 break;
+            results.push_back(evt);
         }
+        return results;
     }
+
+    {
+        std::shared_lock<std::shared_mutex> lock(indexMutex_);
+        for (const Event *e : searchIndex_.match(qToks))
+            results.push_back(idIndex_.at(e->getId()));
+    }
+    std::sort(results.begin(), results.end(), PostingOrder());
+    if (maxResults > 0 && (int)results.size() > maxResults)
+        results.resize(maxResults);
     return results;
 }
 
@@ -674,17 +872,16 @@ std::vector<Event> Model::getEventsInRange(
     std::chrono::system_clock::time_point start,
     std::chrono::system_clock::time_point end) const
 {
-    std::vector<Event> results;
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    auto it_start = events.lower_bound(start);
-    auto it_end = events.upper_bound(end);
+    return copyOut(getEventPtrsInRange(start, end));
+}
 
-    for (auto it = it_start; it != it_end; ++it)
-    {
-        results.push_back(*it->second);
-    }
-    return results;
+std::vector<Model::EventPtr> Model::getEventPtrsInRange(
+    std::chrono::system_clock::time_point start,
+    std::chrono::system_clock::time_point end) const
+{
+    faultIn(start, justAfter(end));
+    auto snap = snapshot();
+    return std::vector<EventPtr>(snap->lowerBound(start), snap->upperBound(end));
 }
 
 std::vector<Event> Model::getEventsInRangeExpanded(
@@ -692,89 +889,251 @@ std::vector<Event> Model::getEventsInRangeExpanded(
     std::chrono::system_clock::time_point end,
     int maxOccurrencesPerSeries) const
 {
-    std::vector<Event> results;
+    return materializeAll(getOccurrencesInRange(start, end, maxOccurrencesPerSeries));
+}
 
-    std::lock_guard<std::mutex> lock(mutex_);
+std::vector<Model::EventPtr> Model::getEventPtrsInRangeExpanded(
+    std::chrono::system_clock::time_point start,
+    std::chrono::system_clock::time_point end,
+    int maxOccurrencesPerSeries) const
+{
+    auto occurrences = getOccurrencesInRange(start, end, maxOccurrencesPerSeries);
+    std::vector<EventPtr> results;
+    results.reserve(occurrences.size());
+    for (auto &o : occurrences)
+    {
+        if (!o.series->isRecurring())
+        {
+            results.push_back(std::move(o.series));
+            continue;
+        }
+        auto copy = o.series->clone();
+        copy->setTime(o.start);
+        results.push_back(std::move(copy));
+    }
+    return results;
+}
 
-    // Iterate all events that could affect the window. Use lower_bound(start)
-    // so we don't consider events strictly before the start unless recurring.
-    // For recurring events that begin before start, we still need occurrences
-    // within [start, end), so we just walk the whole container.
-    for (const auto &kv : events)
+namespace
+{
+    // Append the occurrences of one series in [start, end), at most `cap`
+    void expandSeries(const Model::EventPtr &entry,
+                      std::chrono::system_clock::time_point start,
+                      std::chrono::system_clock::time_point end,
+                      int cap,
+                      std::vector<Occurrence> &out)
     {
-        const Event &e = *kv.second;
-        if (!e.isRecurring())
+        const auto *re = dynamic_cast<const RecurringEvent *>(entry.get());
+        if (!re || !re->getRecurrencePattern())
+            return;
+
+        uint32_t index = 0;
+        auto emit = [&](std::chrono::system_clock::time_point t)
         {
-            if (e.getTime() >= start && e.getTime() < end)
-            {
-                results.push_back(e);
-            }
+            if (static_cast<int>(index) >= cap)
+                return false;
+            out.push_back({entry, t, index++});
+            return true;
+        };
+        // Views ask for the same windows again and again, so prefer the
+        // series' cached times over expanding the pattern
+        OccurrenceCache::Slice cached;
+        if (re->cachedOccurrences(start, end, cached))
+        {
+            for (auto t : cached)
+                if (!emit(t))
+                    break;
         }
         else
         {
-            const auto *re = dynamic_cast<const RecurringEvent *>(kv.second.get());
-            if (!re)
-                continue;
-
-            // Generate occurrences starting just before 'start'
-            auto times = re->getNextNOccurrences(start - std::chrono::seconds(1), maxOccurrencesPerSeries);
-            for (auto t : times)
-            {
-                if (t >= end)
+            for (auto t : re->occurrencesBetween(start, end))
+                if (!emit(t))
                     break;
-                if (t >= start)
-                {
-                    RecurringEvent occ(re->getId(), re->getDescription(), re->getTitle(),
-                                       t, re->getDuration(), re->getRecurrencePattern(),
-                                       re->getCategory());
-                    results.push_back(occ);
-                }
-            }
         }
     }
+} // namespace
 
-    std::sort(results.begin(), results.end(),
-              [](const Event &a, const Event &b) { return a.getTime() < b.getTime(); });
-    return results;
+std::vector<Occurrence> Model::getOccurrencesInRange(
+    std::chrono::system_clock::time_point start,
+    std::chrono::system_clock::time_point end,
+    int maxOccurrencesPerSeries) const
+{
+    faultIn(start, end);
+    std::vector<Occurrence> results;
+
+    // Only series whose span reaches into the window can occur in it; take
+    // them and the snapshot together so both describe the same schedule
+    std::shared_ptr<const EventSnapshot> snap;
+    std::vector<EventPtr> series;
+    {
+        std::shared_lock<std::shared_mutex> lock(indexMutex_);
+        snap = snapshot();
+        seriesSpans_.forEachOverlap(start, end, [&](const Event &event)
+                                    {
+            auto found = idIndex_.find(event.getId());
+            if (found != idIndex_.end())
+                series.push_back(found->second);
+            return true; });
+    }
+
+    // One-time events: just the slice starting inside the window, which is
+    // already in start order
+    for (auto it = snap->lowerBound(start); it != snap->end() && it.start() < end; ++it)
+    {
+        if (!it.isRecurring())
+            results.push_back({*it, it.start(), 0});
+    }
+
+    // Rough cost: every series expanded daily across the window
+    size_t threshold = parallelThreshold_.load();
+    size_t days = std::numeric_limits<size_t>::max();
+    if (start != std::chrono::system_clock::time_point::min() && end != std::chrono::system_clock::time_point::max())
+        days = static_cast<size_t>(std::max<long long>(0, std::chrono::duration_cast<std::chrono::hours>(end - start).count() / 24)) + 1;
+    bool parallel = threshold != 0 && series.size() > 1 &&
+                    days >= (threshold + series.size() - 1) / series.size();
+    auto pool = parallel ? expansionPool() : nullptr;
+    if (!pool)
+    {
+        for (const auto &entry : series)
+            expandSeries(entry, start, end, maxOccurrencesPerSeries, results);
+        std::sort(results.begin(), results.end(), startsBefore);
+        return results;
+    }
+
+    // Each task expands a share of the series into its own sorted run; the
+    // pool hands tasks to whichever worker is free, so uneven series balance out
+    size_t tasks = std::min(series.size(), pool->size() * 4);
+    std::vector<std::future<std::vector<Occurrence>>> expanded;
+    expanded.reserve(tasks);
+    for (size_t task = 0; task < tasks; ++task)
+    {
+        expanded.push_back(pool->enqueue([&series, start, end, maxOccurrencesPerSeries, task, tasks]
+                                         {
+            std::vector<Occurrence> run;
+            for (size_t i = task; i < series.size(); i += tasks)
+                expandSeries(series[i], start, end, maxOccurrencesPerSeries, run);
+            std::sort(run.begin(), run.end(), startsBefore);
+            return run; }));
+    }
+    // Tasks read `series`, so let all of them finish before anything can throw
+    for (auto &f : expanded)
+        f.wait();
+
+    std::vector<std::vector<Occurrence>> runs;
+    runs.reserve(tasks + 1);
+    runs.push_back(std::move(results));
+    for (auto &f : expanded)
+        runs.push_back(f.get());
+
+    // Merge runs pairwise, a round at a time, each pair on its own worker
+    while (runs.size() > 1)
+    {
+        std::vector<std::future<std::vector<Occurrence>>> merged;
+        for (size_t i = 0; i + 1 < runs.size(); i += 2)
+        {
+            merged.push_back(pool->enqueue([a = std::move(runs[i]), b = std::move(runs[i + 1])]() mutable
+                                           {
+                std::vector<Occurrence> out;
+                out.reserve(a.size() + b.size());
+                std::merge(std::make_move_iterator(a.begin()), std::make_move_iterator(a.end()),
+                           std::make_move_iterator(b.begin()), std::make_move_iterator(b.end()),
+                           std::back_inserter(out), startsBefore);
+                return out; }));
+        }
+        std::vector<std::vector<Occurrence>> next;
+        next.reserve(merged.size() + 1);
+        for (auto &f : merged)
+            next.push_back(f.get());
+        if (runs.size() % 2 != 0)
+            next.push_back(std::move(runs.back()));
+        runs = std::move(next);
+    }
+    return std::move(runs.front());
+}
+
+std::shared_ptr<ThreadPool> Model::expansionPool() const
+{
+    std::lock_guard<std::mutex> lock(poolMutex_);
+    if (!expansionPool_ && parallelThreads_ > 1)
+        expansionPool_ = std::make_shared<ThreadPool>(parallelThreads_);
+    return expansionPool_;
+}
+
+void Model::setParallelExpansion(size_t threshold, size_t threads)
+{
+    parallelThreshold_ = threshold;
+    std::lock_guard<std::mutex> lock(poolMutex_);
+    if (threads != parallelThreads_)
+    {
+        // Queries already running keep the old pool until they finish
+        parallelThreads_ = threads;
+        expansionPool_.reset();
+    }
 }
 
 std::vector<Event> Model::getEventsByDuration(int minMinutes, int maxMinutes) const
 {
-    std::vector<Event> results;
-    std::lock_guard<std::mutex> lock(mutex_);
+    return copyOut(getEventPtrsByDuration(minMinutes, maxMinutes));
+}
+
+std::vector<Model::EventPtr> Model::getEventPtrsByDuration(int minMinutes, int maxMinutes) const
+{
+    faultIn(std::chrono::system_clock::time_point::min(), std::chrono::system_clock::time_point::max());
+    std::vector<EventPtr> results;
+    auto snap = snapshot();
 
-    for (auto it = events.begin(); it != events.end(); ++it)
+    for (auto it = snap->begin(); it != snap->end(); ++it)
     {
-        const auto &event = it->second;
-        auto durationMin = std::chrono::duration_cast<std::chrono::minutes>(event->getDuration()).count();
+        auto durationMin = std::chrono::duration_cast<std::chrono::minutes>(it.duration()).count();
         if (durationMin >= minMinutes && durationMin <= maxMinutes)
         {
-            results.push_back(*event);
+            results.push_back(*it);
         }
     }
     return results;
 }
 
-std::vector<Event> Model::getEventsByCategory(const std::string &category) const
+std::vector<Event> Model::getEventsByCategory(const std::string &category) const
+{
+    return copyOut(getEventPtrsByCategory(category));
+}
+
+std::vector<Model::EventPtr> Model::getEventPtrsByCategory(const std::string &category) const
 {
-    std::vector<Event> results;
-    std::lock_guard<std::mutex> lock(mutex_);
+    faultIn(std::chrono::system_clock::time_point::min(), std::chrono::system_clock::time_point::max());
+    std::shared_lock<std::shared_mutex> lock(indexMutex_);
 
-    for (auto it = events.begin(); it != events.end(); ++it)
+    auto list = categoryIndex_.find(category);
+    if (list == categoryIndex_.end())
+        return {};
+    return std::vector<EventPtr>(list->second.begin(), list->second.end());
+}
+
+std::set<std::string> Model::getCategories() const
+{
+    faultIn(std::chrono::system_clock::time_point::min(), std::chrono::system_clock::time_point::max());
+    std::set<std::string> names;
+    std::shared_lock<std::shared_mutex> lock(indexMutex_);
+    for (const auto &entry : categoryIndex_)
     {
-        const auto &event = it->second;
-        if (event->getCategory() == category)
-        {
-            results.push_back(*event);
-        }
+        // Uncategorized events are indexed under "" but it is not a category
+        if (!entry.first.empty())
+            names.insert(names.end(), entry.first);
     }
-    return results;
+    return names;
 }
 
-std::set<std::string> Model::getCategories() const
+std::map<std::string, size_t> Model::getCategoryCounts() const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return categories_;
+    faultIn(std::chrono::system_clock::time_point::min(), std::chrono::system_clock::time_point::max());
+    std::map<std::string, size_t> counts;
+    std::shared_lock<std::shared_mutex> lock(indexMutex_);
+    for (const auto &entry : categoryIndex_)
+    {
+        if (!entry.first.empty())
+            counts.emplace_hint(counts.end(), entry.first, entry.second.size());
+    }
+    return counts;
 }
 
 std::vector<Event> Model::getConflicts(
@@ -783,20 +1142,10 @@ std::vector<Event> Model::getConflicts(
 {
     std::vector<Event> conflicts;
     auto eventEnd = time + duration;
+    faultInOverlapping(time, eventEnd);
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (auto it = events.begin(); it != events.end(); ++it)
-    {
-        const auto &existingTime = it->first;
-        const auto &event = it->second;
-        auto existingEnd = existingTime + event->getDuration();
-
-        // Check if times overlap
-        if (!(eventEnd <= existingTime || time >= existingEnd))
-        {
-            conflicts.push_back(*event);
-        }
-    }
+    std::shared_lock<std::shared_mutex> lock(indexMutex_);
+    collectConflictsLocked(time, eventEnd, std::numeric_limits<size_t>::max(), conflicts);
     return conflicts;
 }
 
@@ -813,35 +1162,30 @@ std::vector<TimeSlot> Model::findFreeSlots(
     auto workStart = dayStart + std::chrono::hours(startHour);
     auto workEnd = dayStart + std::chrono::hours(endHour);
 
-    // Get all events for this day
-    auto dayEvents = getEventsOnDay(date);
-
-    // Sort events by time
-    std::sort(dayEvents.begin(), dayEvents.end(),
-              [](const Event &a, const Event &b)
-              { return a.getTime() < b.getTime(); });
+    // Get everything on this day, already in start order
+    auto dayEvents = getOccurrencesOnDay(date);
 
     // Find gaps
     auto currentTime = workStart;
 
     for (const auto &event : dayEvents)
     {
-        if (event.getTime() > currentTime && event.getTime() < workEnd)
+        if (event.start > currentTime && event.start < workEnd)
         {
             auto gap = std::chrono::duration_cast<std::chrono::minutes>(
-                event.getTime() - currentTime);
+                event.start - currentTime);
 
             if (gap.count() >= minDurationMinutes)
             {
                 TimeSlot slot;
                 slot.start = currentTime;
-                slot.end = event.getTime();
+                slot.end = event.start;
                 slot.duration = gap;
                 freeSlots.push_back(slot);
             }
         }
 
-        auto eventEnd = event.getTime() + event.getDuration();
+        auto eventEnd = event.end();
         if (eventEnd > currentTime)
         {
             currentTime = eventEnd;
@@ -912,27 +1256,26 @@ EventStats Model::getEventStats(
     std::map<std::chrono::system_clock::time_point, int> eventsByDay;
     std::map<int, int> eventsByHour;
 
-    auto events = getEventsInRangeExpanded(start, end);
+    auto occurrences = getOccurrencesInRange(start, end);
 
-    for (const auto &event : events)
+    for (const auto &occ : occurrences)
     {
+        const Event &event = occ.event();
         stats.totalEvents++;
         stats.totalMinutes += std::chrono::duration_cast<std::chrono::minutes>(
                                   event.getDuration())
                                   .count();
 
         // Count by category
-        std::string category = event.getCategory();
-        if (category.empty())
-            category = "Uncategorized";
-        stats.eventsByCategory[category]++;
+        const std::string &category = event.getCategory();
+        stats.eventsByCategory[category.empty() ? std::string("Uncategorized") : category]++;
 
         // Count by day
-        auto dayStart = startOfLocalDay(event.getTime());
+        auto dayStart = startOfLocalDay(occ.start);
         eventsByDay[dayStart]++;
 
         // Count by hour
-        time_t t = std::chrono::system_clock::to_time_t(event.getTime());
+        time_t t = std::chrono::system_clock::to_time_t(occ.start);
         std::tm tm_buf;
 #if defined(_MSC_VER)
         localtime_s(&tm_buf, &t);
@@ -970,42 +1313,54 @@ EventStats Model::getEventStats(
 
 bool Model::updateEvent(const std::string &id, const Event &updatedEvent)
 {
-    std::unique_ptr<Event> oldEvent;
+    const bool renamed = updatedEvent.getId() != id;
+    faultInId(id);
+    if (renamed)
+    {
+        faultInId(updatedEvent.getId());
+    }
+    EventPtr oldEvent;
     std::vector<std::shared_ptr<CalendarApi>> apisCopy;
     {
         std::lock_guard<std::mutex> lock(mutex_);
 
-        // Find and remove the old event
-        for (auto it = events.begin(); it != events.end(); ++it)
+        // Find the old event and swap in the updated one
+        auto found = idIndex_.find(id);
+        if (found == idIndex_.end())
         {
-            if (it->second->getId() == id)
-            {
-                oldEvent = std::move(it->second);
-                events.erase(it);
-                break;
-            }
+            return false;
         }
-
-        if (!oldEvent)
+        // A new ID must be free, as it would be for addEvent
+        if (renamed && (eventExists(updatedEvent.getId()) ||
+                        (!diskTombstones_ && tombstones_.count(updatedEvent.getId()))))
         {
             return false;
         }
+        oldEvent = found->second;
 
-        // Add the updated event with the same ID
-        auto newEvent = updatedEvent.clone();
-        events.emplace(updatedEvent.getTime(), std::move(newEvent));
-
-        // Update category tracking
-        std::string newCategory = updatedEvent.getCategory();
-        if (!newCategory.empty())
+        // Store first; a new ID moves the row with its delete and insert in
+        // one batch. Memory follows only if the store took the change.
+        if (db_)
         {
-            categories_.insert(newCategory);
+            bool stored;
+            if (!renamed)
+            {
+                stored = db_->updateFields(updatedEvent, changedFields(*oldEvent, updatedEvent));
+            }
+            else
+            {
+                stored = db_->writeEvents({{id, nullptr}, {updatedEvent.getId(), &updatedEvent}});
+            }
+            if (!stored)
+            {
+                return false;
+            }
         }
-
-        if (db_)
         {
-            db_->removeEvent(id);
-            db_->addEvent(updatedEvent);
+            std::unique_lock<std::shared_mutex> index(indexMutex_);
+            EventSnapshot::Builder draft(snapshot_);
+            replaceLocked(draft, oldEvent, updatedEvent.clone());
+            publishLocked(draft);
         }
 
         apisCopy = apis_;
@@ -1031,7 +1386,7 @@ bool Model::updateEvent(const std::string &id, const Event &updatedEvent)
         std::unordered_map<std::string, std::string> f;
         if (!collectedIds.eventId.empty()) f["provider_event_id"] = collectedIds.eventId;
         if (!collectedIds.taskId.empty()) f["provider_task_id"] = collectedIds.taskId;
-        updateEventFields(id, f);
+        updateEventFields(updatedEvent.getId(), f);
     }
 
     return true;
@@ -1040,54 +1395,58 @@ bool Model::updateEvent(const std::string &id, const Event &updatedEvent)
 bool Model::updateEventFields(const std::string &id,
                              const std::unordered_map<std::string, std::string> &fields)
 {
-    std::unique_ptr<Event> oldEventCopy;
+    faultInId(id);
+    EventPtr oldEventCopy;
+    EventPtr eventToUpdate;
     std::vector<std::shared_ptr<CalendarApi>> apisCopy;
-    Event *eventToUpdate = nullptr;
     {
         std::lock_guard<std::mutex> lock(mutex_);
 
-        for (auto it = events.begin(); it != events.end(); ++it)
+        auto found = idIndex_.find(id);
+        if (found != idIndex_.end())
         {
-            const auto &event = it->second;
-            if (event->getId() == id)
-            {
-                // Make a copy of the old event for API notification
-                oldEventCopy = event->clone();
-                eventToUpdate = event.get();
-
-                // Update each field if present
-                if (fields.count("title"))
-                {
-                    event->setTitle(fields.at("title"));
-                }
-                if (fields.count("description"))
-                {
-                    event->setDescription(fields.at("description"));
-                }
-                if (fields.count("category"))
-                {
-                    event->setCategory(fields.at("category"));
-                    categories_.insert(fields.at("category"));
-                }
-                if (fields.count("provider_event_id"))
-                {
-                    event->setProviderEventId(fields.at("provider_event_id"));
-                }
-                if (fields.count("provider_task_id"))
-                {
-                    event->setProviderTaskId(fields.at("provider_task_id"));
-                }
+            // Published events are immutable: edit a copy and swap it in
+            oldEventCopy = found->second;
+            std::unique_ptr<Event> event = oldEventCopy->clone();
+            event->clearDirty();
 
-                // Update database
-                if (db_)
-                {
-                    db_->removeEvent(id);
-                    db_->addEvent(*event);
-                }
+            // Update each field if present
+            if (fields.count("title"))
+            {
+                event->setTitle(fields.at("title"));
+            }
+            if (fields.count("description"))
+            {
+                event->setDescription(fields.at("description"));
+            }
+            if (fields.count("category"))
+            {
+                event->setCategory(fields.at("category"));
+            }
+            if (fields.count("provider_event_id"))
+            {
+                event->setProviderEventId(fields.at("provider_event_id"));
+            }
+            if (fields.count("provider_task_id"))
+            {
+                event->setProviderTaskId(fields.at("provider_task_id"));
+            }
+            eventToUpdate = std::move(event);
 
-                apisCopy = apis_;
-                break;
+            // Write back only the columns this edit touched, and swap the
+            // copy in only once they are stored
+            if (db_ && !db_->updateFields(*eventToUpdate, eventToUpdate->dirtyFields()))
+            {
+                return false;
+            }
+            {
+                std::unique_lock<std::shared_mutex> index(indexMutex_);
+                EventSnapshot::Builder draft(snapshot_);
+                replaceLocked(draft, oldEventCopy, eventToUpdate);
+                publishLocked(draft);
             }
+
+            apisCopy = apis_;
         }
     }
 
@@ -1124,108 +1483,380 @@ bool Model::updateEventFields(const std::string &id,
 
 std::unique_ptr<Event> Model::getEventById(const std::string &id) const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
+    faultInId(id);
+    std::shared_lock<std::shared_mutex> lock(indexMutex_);
 
-    for (auto it = events.begin(); it != events.end(); ++it)
+    auto found = idIndex_.find(id);
+    if (found == idIndex_.end())
     {
-        const auto &event = it->second;
-        if (event->getId() == id)
-        {
-            return event->clone();
-        }
+        return nullptr;
     }
-    return nullptr;
+    return found->second->clone();
 }
 
 bool Model::validateEventTime(const Event &e) const
 {
-    auto conflicts = getConflicts(e.getTime(),
-                                  std::chrono::duration_cast<std::chrono::minutes>(e.getDuration()));
+    // Any single overlap is enough to reject, so stop at the first one
+    auto start = e.getTime();
+    auto end = start + std::chrono::duration_cast<std::chrono::minutes>(e.getDuration());
+    faultInOverlapping(start, end);
+    std::vector<Event> conflicts;
+    std::shared_lock<std::shared_mutex> lock(indexMutex_);
+    collectConflictsLocked(start, end, 1, conflicts);
     return conflicts.empty();
 }
 
 std::vector<bool> Model::addEvents(const std::vector<Event> &newEvents)
 {
-    std::vector<bool> results;
-    results.reserve(newEvents.size());
-
+    std::vector<bool> results(newEvents.size(), false);
     for (const auto &event : newEvents)
+        faultInId(event.getId());
+
+    std::vector<EventPtr> added;
+    std::vector<std::shared_ptr<CalendarApi>> apisCopy;
     {
-        results.push_back(addEvent(event));
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::unordered_set<std::string> batchIds;
+        for (size_t i = 0; i < newEvents.size(); ++i)
+        {
+            if (eventExists(newEvents[i].getId()) || !batchIds.insert(newEvents[i].getId()).second)
+                continue;
+            added.push_back(newEvents[i].clone());
+            results[i] = true;
+        }
+        if (added.empty())
+            return results;
+
+        // The store takes the whole batch or none of it; memory follows
+        if (db_)
+        {
+            std::vector<IScheduleDatabase::EventWrite> writes;
+            writes.reserve(added.size());
+            for (const auto &e : added)
+                writes.push_back({e->getId(), e.get()});
+            if (!db_->writeEvents(writes))
+                return std::vector<bool>(newEvents.size(), false);
+        }
+        {
+            std::unique_lock<std::shared_mutex> index(indexMutex_);
+            EventSnapshot::Builder draft(snapshot_);
+            for (const auto &e : added)
+                insertLocked(draft, e);
+            publishLocked(draft);
+        }
+        apisCopy = apis_;
     }
+    if (apisCopy.empty())
+        return results;
 
+    // Notify all calendar APIs and capture provider IDs
+    std::vector<const Event *> batch;
+    batch.reserve(added.size());
+    for (const auto &e : added)
+        batch.push_back(e.get());
+    std::vector<std::pair<std::string, ProviderIds>> collected(added.size());
+    for (size_t i = 0; i < added.size(); ++i)
+        collected[i].first = added[i]->getId();
+    for (auto &api : apisCopy)
+    {
+        try
+        {
+            auto ids = api->addEvents(batch);
+            for (size_t i = 0; i < ids.size() && i < collected.size(); ++i)
+            {
+                if (!ids[i].eventId.empty()) collected[i].second.eventId = ids[i].eventId;
+                if (!ids[i].taskId.empty()) collected[i].second.taskId = ids[i].taskId;
+            }
+        }
+        catch (const std::exception &ex)
+        {
+            // Log error but don't fail the entire operation
+        }
+    }
+    if (!recordProviderIds(collected))
+        Logger::warn("[model] could not store provider IDs for ", collected.size(), " events");
     return results;
 }
 
 int Model::removeEvents(const std::vector<std::string> &ids)
 {
-    int removed = 0;
     for (const auto &id : ids)
+        faultInId(id);
+
+    std::vector<EventPtr> removedEvents;
+    std::vector<std::shared_ptr<CalendarApi>> apisCopy;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::unordered_set<std::string> batchIds;
+        for (const auto &id : ids)
+        {
+            auto found = idIndex_.find(id);
+            if (found == idIndex_.end() || !batchIds.insert(id).second)
+                continue;
+            removedEvents.push_back(found->second);
+        }
+        if (removedEvents.empty())
+            return 0;
+
+        if (db_)
+        {
+            std::vector<IScheduleDatabase::EventWrite> writes;
+            writes.reserve(removedEvents.size());
+            for (const auto &e : removedEvents)
+                writes.push_back({e->getId(), nullptr});
+            if (!db_->writeEvents(writes))
+                return 0;
+        }
+        {
+            std::unique_lock<std::shared_mutex> index(indexMutex_);
+            EventSnapshot::Builder draft(snapshot_);
+            for (const auto &e : removedEvents)
+                eraseLocked(draft, e);
+            publishLocked(draft);
+        }
+        apisCopy = apis_;
+    }
+
+    // Notify all calendar APIs
+    if (!removedEvents.empty())
     {
-        if (removeEvent(id, false)) // Use hard delete
+        std::vector<const Event *> batch;
+        batch.reserve(removedEvents.size());
+        for (const auto &e : removedEvents)
+            batch.push_back(e.get());
+        for (auto &api : apisCopy)
         {
-            removed++;
+            try
+            {
+                api->deleteEvents(batch);
+            }
+            catch (const std::exception &ex)
+            {
+                // Log error but continue
+            }
         }
     }
-    return removed;
+    return static_cast<int>(removedEvents.size());
 }
 
 std::vector<bool> Model::updateEvents(
     const std::vector<std::pair<std::string, Event>> &updates)
 {
-    std::vector<bool> results;
-    results.reserve(updates.size());
+    std::vector<bool> results(updates.size(), false);
+    for (const auto &update : updates)
+        faultInId(update.first);
 
-    for (auto it = updates.begin(); it != updates.end(); ++it)
+    // (old, new) for each applied update, in batch order
+    std::vector<std::pair<EventPtr, EventPtr>> changes;
+    std::vector<std::shared_ptr<CalendarApi>> apisCopy;
     {
-        const auto &id = it->first;
-        const auto &event = it->second;
-        results.push_back(updateEvent(id, event));
+        std::lock_guard<std::mutex> lock(mutex_);
+        // The batch is planned against the index as earlier updates in it
+        // leave it: ID -> its event after them, null once moved away
+        std::unordered_map<std::string, EventPtr> planned;
+        auto current = [&](const std::string &id) -> EventPtr
+        {
+            auto it = planned.find(id);
+            if (it != planned.end())
+                return it->second;
+            auto found = idIndex_.find(id);
+            return found == idIndex_.end() ? nullptr : found->second;
+        };
+        for (size_t i = 0; i < updates.size(); ++i)
+        {
+            EventPtr oldEvent = current(updates[i].first);
+            if (!oldEvent)
+                continue;
+            EventPtr newEvent = updates[i].second.clone();
+            // A new ID must be free, as for updateEvent
+            if (newEvent->getId() != oldEvent->getId())
+            {
+                if (current(newEvent->getId()) || (!diskTombstones_ && tombstones_.count(newEvent->getId())))
+                    continue;
+                planned[oldEvent->getId()] = nullptr;
+            }
+            planned[newEvent->getId()] = newEvent;
+            changes.emplace_back(std::move(oldEvent), std::move(newEvent));
+            results[i] = true;
+        }
+        if (changes.empty())
+            return results;
+
+        if (db_)
+        {
+            std::vector<IScheduleDatabase::EventWrite> writes;
+            writes.reserve(changes.size());
+            for (const auto &change : changes)
+            {
+                // An update may move the event to a new ID; drop the old row
+                if (change.first->getId() != change.second->getId())
+                {
+                    writes.push_back({change.first->getId(), nullptr});
+                    writes.push_back({change.second->getId(), change.second.get()});
+                }
+                else
+                {
+                    writes.push_back({change.second->getId(), change.second.get(),
+                                      changedFields(*change.first, *change.second)});
+                }
+            }
+            if (!db_->writeEvents(writes))
+                return std::vector<bool>(updates.size(), false);
+        }
+        {
+            std::unique_lock<std::shared_mutex> index(indexMutex_);
+            EventSnapshot::Builder draft(snapshot_);
+            for (const auto &change : changes)
+                replaceLocked(draft, change.first, change.second);
+            publishLocked(draft);
+        }
+        apisCopy = apis_;
     }
+    if (apisCopy.empty())
+        return results;
 
+    // Notify APIs and collect provider IDs
+    std::vector<std::pair<const Event *, const Event *>> batch;
+    batch.reserve(changes.size());
+    for (const auto &change : changes)
+        batch.emplace_back(change.first.get(), change.second.get());
+    std::vector<std::pair<std::string, ProviderIds>> collected(changes.size());
+    for (size_t i = 0; i < changes.size(); ++i)
+        collected[i].first = changes[i].second->getId();
+    for (auto &api : apisCopy)
+    {
+        try
+        {
+            auto ids = api->updateEvents(batch);
+            for (size_t i = 0; i < ids.size() && i < collected.size(); ++i)
+            {
+                if (!ids[i].eventId.empty()) collected[i].second.eventId = ids[i].eventId;
+                if (!ids[i].taskId.empty()) collected[i].second.taskId = ids[i].taskId;
+            }
+        }
+        catch (const std::exception &ex)
+        {
+            // Log error but don't fail the entire operation
+        }
+    }
+    if (!recordProviderIds(collected))
+        Logger::warn("[model] could not store provider IDs for ", collected.size(), " events");
     return results;
 }
 
+bool Model::recordProviderIds(const std::vector<std::pair<std::string, ProviderIds>> &ids)
+{
+    // (current, with provider IDs) per event; a repeated ID edits its
+    // earlier copy
+    std::vector<std::pair<EventPtr, EventPtr>> updated;
+    std::unordered_map<std::string, size_t> positions;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &entry : ids)
+    {
+        const auto &provider = entry.second;
+        if (provider.eventId.empty() && provider.taskId.empty())
+            continue;
+        auto position = positions.find(entry.first);
+        EventPtr current;
+        if (position != positions.end())
+            current = updated[position->second].second;
+        else
+        {
+            auto found = idIndex_.find(entry.first);
+            if (found == idIndex_.end())
+                continue;
+            current = found->second;
+        }
+        // Published events are immutable: edit a copy and swap it in
+        std::unique_ptr<Event> event = current->clone();
+        if (position == positions.end())
+            event->clearDirty();
+        if (!provider.eventId.empty()) event->setProviderEventId(provider.eventId);
+        if (!provider.taskId.empty()) event->setProviderTaskId(provider.taskId);
+        if (position != positions.end())
+            updated[position->second].second = std::move(event);
+        else
+        {
+            positions[entry.first] = updated.size();
+            updated.emplace_back(std::move(current), std::move(event));
+        }
+    }
+    if (updated.empty())
+        return true;
+
+    if (db_)
+    {
+        std::vector<IScheduleDatabase::EventWrite> writes;
+        writes.reserve(updated.size());
+        for (const auto &change : updated)
+            writes.push_back({change.second->getId(), change.second.get(), change.second->dirtyFields()});
+        if (!db_->writeEvents(writes))
+            return false;
+    }
+    std::unique_lock<std::shared_mutex> index(indexMutex_);
+    EventSnapshot::Builder draft(snapshot_);
+    for (const auto &change : updated)
+        replaceLocked(draft, change.first, change.second);
+    publishLocked(draft);
+    return true;
+}
+
 // ====== SOFT DELETE FUNCTIONALITY WITH API INTEGRATION ======
 
 bool Model::removeEvent(const std::string &id, bool softDelete)
 {
+    faultInId(id);
     if (softDelete)
     {
         std::lock_guard<std::mutex> lock(mutex_);
 
         // Find and move to deleted events (no API notification for soft delete)
-        for (auto it = events.begin(); it != events.end(); ++it)
+        auto found = idIndex_.find(id);
+        if (found == idIndex_.end())
         {
-            if (it->second->getId() == id)
-            {
-                deletedEvents.emplace(it->first, std::move(it->second));
-                events.erase(it);
-                return true;
-            }
+            return false;
         }
-        return false;
+        EventPtr removed = found->second;
+        // Whole seconds, as the tombstone store keeps them, so expiry here
+        // and in the store agree
+        auto now = std::chrono::time_point_cast<std::chrono::seconds>(std::chrono::system_clock::now());
+        // Move the row to the tombstone table first, deleting it only once
+        // the copy is in; memory follows only if the store took both
+        if (diskTombstones_ && !writeAtomically(*db_, [&]
+                                                { return db_->addTombstone(*removed, now) && db_->removeEvent(id); }))
+            return false;
+        {
+            std::unique_lock<std::shared_mutex> index(indexMutex_);
+            EventSnapshot::Builder draft(snapshot_);
+            eraseLocked(draft, removed);
+            publishLocked(draft);
+            addTombstoneLocked(removed, now);
+        }
+        compactTombstonesLocked(now);
+        return true;
     }
     else
     {
         // Regular hard delete with API notification
-        std::unique_ptr<Event> removedEvent;
+        EventPtr removedEvent;
         std::vector<std::shared_ptr<CalendarApi>> apisCopy;
         {
             std::lock_guard<std::mutex> lock(mutex_);
-            for (auto it = events.begin(); it != events.end(); ++it)
+            auto found = idIndex_.find(id);
+            if (found != idIndex_.end())
             {
-                if (it->second->getId() == id)
+                removedEvent = found->second;
                 {
-                    removedEvent = it->second->clone();
-                    events.erase(it);
-                    if (db_)
-                    {
-                        db_->removeEvent(id);
-                    }
-                    apisCopy = apis_;
-                    break;
+                    std::unique_lock<std::shared_mutex> index(indexMutex_);
+                    EventSnapshot::Builder draft(snapshot_);
+                    eraseLocked(draft, removedEvent);
+                    publishLocked(draft);
+                }
+                if (db_)
+                {
+                    db_->removeEvent(id);
                 }
+                apisCopy = apis_;
             }
         }
 
@@ -1254,45 +1885,195 @@ bool Model::removeEvent(const Event &event)
     return removeEvent(event.getId(), false); // Call the version with softDelete = false
 }
 
-std::vector<Event> Model::getDeletedEvents() const
+Model::ChangeSet Model::getChangesSince(uint64_t since) const
+{
+    ChangeSet result;
+    std::vector<ChangeLog::Record> records;
+    std::shared_lock<std::shared_mutex> lock(indexMutex_);
+    result.version = changes_.version();
+    if (!changes_.since(since, records))
+    {
+        result.resync = true;
+        return result;
+    }
+
+    // Latest change per ID wins; walk newest first and keep first sightings
+    std::unordered_set<std::string> seen;
+    for (auto it = records.rbegin(); it != records.rend(); ++it)
+    {
+        if (!seen.insert(it->id).second)
+            continue;
+        auto found = idIndex_.find(it->id);
+        if (it->kind == ChangeLog::Kind::Upsert && found != idIndex_.end())
+            result.upserts.push_back(found->second);
+        else
+            result.deletes.push_back(it->id);
+    }
+    std::sort(result.upserts.begin(), result.upserts.end(), PostingOrder());
+    return result;
+}
+
+uint64_t Model::changeVersion() const
+{
+    std::shared_lock<std::shared_mutex> lock(indexMutex_);
+    return changes_.version();
+}
+
+std::vector<Event> Model::getDeletedEvents(size_t offset, size_t limit) const
 {
     std::vector<Event> results;
-    std::lock_guard<std::mutex> lock(mutex_);
+    auto now = std::chrono::system_clock::now();
+    if (diskTombstones_)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto cutoff = tombstoneCutoff(now);
+        // Until compaction purges them, expired rows are still in the store.
+        // Without any the store can page; otherwise skip them here first.
+        if (tombstoneOrder_.empty() || !(tombstoneOrder_.begin()->first < cutoff))
+        {
+            for (const auto &e : db_->getTombstones(offset, limit))
+                results.push_back(*e);
+            return results;
+        }
+        size_t skipped = 0;
+        for (const auto &e : db_->getTombstones(0, 0))
+        {
+            auto found = tombstones_.find(e->getId());
+            if (found == tombstones_.end() || found->second.order->first < cutoff)
+                continue;
+            if (skipped++ < offset)
+                continue;
+            if (limit != 0 && results.size() == limit)
+                break;
+            results.push_back(*e);
+        }
+        return results;
+    }
 
-    for (auto it = deletedEvents.begin(); it != deletedEvents.end(); ++it)
+    std::vector<EventPtr> deleted;
     {
-        const auto &event = it->second;
-        results.push_back(*event);
+        std::shared_lock<std::shared_mutex> lock(indexMutex_);
+        auto cutoff = tombstoneCutoff(now);
+        deleted.reserve(tombstones_.size());
+        for (const auto &entry : tombstones_)
+            if (!(entry.second.order->first < cutoff))
+                deleted.push_back(entry.second.event);
     }
+    std::sort(deleted.begin(), deleted.end(), PostingOrder());
+    size_t end = limit == 0 ? deleted.size() : std::min(deleted.size(), offset + limit);
+    for (size_t i = offset; i < end; ++i)
+        results.push_back(*deleted[i]);
     return results;
 }
 
+void Model::setTombstoneRetention(std::chrono::system_clock::duration ttl, size_t maxTombstones)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    {
+        std::unique_lock<std::shared_mutex> index(indexMutex_);
+        tombstoneTtl_ = ttl;
+        maxTombstones_ = maxTombstones;
+    }
+    compactTombstonesLocked(std::chrono::system_clock::now());
+}
+
+void Model::compactTombstones()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    compactTombstonesLocked(std::chrono::system_clock::now());
+}
+
+void Model::addTombstoneLocked(const EventPtr &e, std::chrono::system_clock::time_point deletedAt)
+{
+    // A newer soft delete of the same ID supersedes the older tombstone
+    auto previous = tombstones_.find(e->getId());
+    if (previous != tombstones_.end())
+        eraseTombstoneLocked(previous);
+    auto order = tombstoneOrder_.emplace(deletedAt, e->getId());
+    tombstones_[e->getId()] = Tombstone{order, diskTombstones_ ? nullptr : e};
+}
+
+void Model::eraseTombstoneLocked(std::unordered_map<std::string, Tombstone>::iterator it)
+{
+    tombstoneOrder_.erase(it->second.order);
+    tombstones_.erase(it);
+}
+
+std::chrono::system_clock::time_point Model::tombstoneCutoff(std::chrono::system_clock::time_point now) const
+{
+    auto epoch = std::chrono::system_clock::time_point();
+    return now - epoch > tombstoneTtl_ ? now - tombstoneTtl_ : epoch;
+}
+
+void Model::compactTombstonesLocked(std::chrono::system_clock::time_point now)
+{
+    auto cutoff = tombstoneCutoff(now);
+    bool expired = false;
+    std::vector<std::string> evicted;
+    {
+        std::unique_lock<std::shared_mutex> index(indexMutex_);
+        while (!tombstoneOrder_.empty() &&
+               (tombstoneOrder_.begin()->first < cutoff || tombstones_.size() > maxTombstones_))
+        {
+            auto oldest = tombstoneOrder_.begin();
+            if (oldest->first < cutoff)
+                expired = true;
+            else
+                evicted.push_back(oldest->second);
+            eraseTombstoneLocked(tombstones_.find(oldest->second));
+        }
+    }
+    if (!diskTombstones_)
+        return;
+    // One range delete covers every expired row; rows evicted over the
+    // count bound go one by one
+    if (expired)
+        db_->purgeTombstones(cutoff);
+    for (const auto &id : evicted)
+        db_->removeTombstone(id);
+}
+
 bool Model::restoreEvent(const std::string &id)
 {
-    std::unique_ptr<Event> restoredEvent;
+    faultInId(id);
+    EventPtr restoredEvent;
     std::vector<std::shared_ptr<CalendarApi>> apisCopy;
     {
         std::lock_guard<std::mutex> lock(mutex_);
 
-        // Find in deleted events
-        for (auto it = deletedEvents.begin(); it != deletedEvents.end(); ++it)
+        // Find in deleted events; refuse if the ID has been reused since or
+        // the tombstone has expired but not been purged yet
+        auto found = tombstones_.find(id);
+        if (found != tombstones_.end() && !eventExists(id) &&
+            !(found->second.order->first < tombstoneCutoff(std::chrono::system_clock::now())))
         {
-            if (it->second->getId() == id)
+            restoredEvent = found->second.event;
+            if (!restoredEvent)
+                restoredEvent = db_->getTombstone(id);
+            if (!restoredEvent)
             {
-                restoredEvent = it->second->clone();
-                // Move back to active events
-                events.emplace(it->first, std::move(it->second));
-                deletedEvents.erase(it);
-
-                // Update database
-                if (db_)
-                {
-                    db_->addEvent(*restoredEvent);
-                }
-
-                apisCopy = apis_;
-                break;
+                // The row is gone from the store; drop the stale ID too
+                std::unique_lock<std::shared_mutex> index(indexMutex_);
+                eraseTombstoneLocked(found);
+                return false;
             }
+
+            // Re-insert the row before dropping its tombstone, as one
+            // commit; on failure the event stays deleted
+            if (db_ && !writeAtomically(*db_, [&]
+                                        { return db_->addEvent(*restoredEvent) &&
+                                                 (!diskTombstones_ || db_->removeTombstone(id)); }))
+                return false;
+
+            // Move back to active events
+            std::unique_lock<std::shared_mutex> index(indexMutex_);
+            eraseTombstoneLocked(found);
+            EventSnapshot::Builder draft(snapshot_);
+            insertLocked(draft, restoredEvent);
+            publishLocked(draft);
+            index.unlock();
+
+            apisCopy = apis_;
         }
     }
 
@@ -1,15 +1,25 @@
 #pragma once
+#include <atomic>
 #include <map>
 #include <mutex>
+#include <shared_mutex>
 #include <chrono>
 #include <string>
 #include <memory>
 #include <set>
+#include <thread>
 #include <unordered_map>
 #include "Event.h"
 #include "ReadOnlyModel.h"
+#include "IntervalIndex.h"
+#include "SearchIndex.h"
+#include "ChangeLog.h"
+#include "EventSnapshot.h"
+#include "Occurrence.h"
 #include "../database/IScheduleDatabase.h"
 #include "../calendar/CalendarApi.h"
+
+class ThreadPool;
 #include <vector>
 
 // Structure to hold event statistics
@@ -32,32 +42,166 @@ struct TimeSlot
 
 /*
   Model extends ReadOnlyModel by adding mutators (addEvent, removeEvent).
-  Internally it keeps events in a time-ordered container. Access is protected
-  by a mutex so multiple API threads can modify the schedule concurrently.
+  Events live in an immutable, time-ordered EventSnapshot that writers
+  replace atomically, so range queries read a consistent snapshot without
+  locking. Writers are serialized by mutex_, which they also hold across
+  database calls; the lookup indexes are guarded by indexMutex_, which
+  writers hold only while editing memory.
 */
 class Model : public ReadOnlyModel
 {
+public:
+  // Shared, immutable event as stored in the model
+  using EventPtr = EventSnapshot::EventPtr;
+
 private:
-  std::multimap<std::chrono::system_clock::time_point, std::unique_ptr<Event>> events;
+  // Published view; always access through snapshot()/publishLocked()
+  std::shared_ptr<const EventSnapshot> snapshot_;
+  // ID -> live event
+  std::unordered_map<std::string, EventPtr> idIndex_;
+  // Overlap index over each event's busy span (a whole series for recurring
+  // events), used by getConflicts/validateEventTime.
+  IntervalIndex intervals_;
+  // The same spans for recurring series alone, so range expansion visits
+  // only the series that reach into the window and skips finished ones.
+  IntervalIndex seriesSpans_;
   IScheduleDatabase *db_;
   mutable std::mutex mutex_;
-  std::chrono::system_clock::time_point preloadEnd_;
+  mutable std::shared_mutex indexMutex_;
+  // Paging mode (a database and preloadDaysAhead >= 0): recurring series
+  // are always resident, one-time events only over the spans in loaded_.
+  // Queries fault missing spans in from db_; otherwise everything is loaded
+  // up front and the members below are unused.
+  bool paging_ = false;
+  // Disjoint [start, end) spans whose one-time events are all resident,
+  // keyed by start. Guarded by mutex_.
+  mutable std::map<std::chrono::system_clock::time_point, std::chrono::system_clock::time_point> loaded_;
+  // Longest one-time event known, so overlap queries know how far back to
+  // load. Guarded by mutex_.
+  mutable std::chrono::system_clock::duration longest_{0};
   std::vector<std::shared_ptr<CalendarApi>> apis_;
 
-  // New: Categories tracking
-  std::set<std::string> categories_;
-
-  // New: Soft delete support
-  std::multimap<std::chrono::system_clock::time_point, std::unique_ptr<Event>> deletedEvents;
+  // Category -> posting list of its events in (time, id) order. Lists are
+  // dropped as soon as they empty, so the key set is the live category set.
+  struct PostingOrder
+  {
+    bool operator()(const EventPtr &a, const EventPtr &b) const;
+  };
+  std::map<std::string, std::set<EventPtr, PostingOrder>> categoryIndex_;
+  // Word index over titles and descriptions for searchEvents.
+  SearchIndex searchIndex_;
+  // Recent upserts and deletes for delta sync. Guarded by indexMutex_.
+  ChangeLog changes_;
+
+  // Parallel range expansion, see setParallelExpansion. The pool is created
+  // on first use; both it and parallelThreads_ are guarded by poolMutex_.
+  std::atomic<size_t> parallelThreshold_{kDefaultParallelThreshold};
+  size_t parallelThreads_ = std::thread::hardware_concurrency();
+  mutable std::mutex poolMutex_;
+  mutable std::shared_ptr<ThreadPool> expansionPool_;
+  std::shared_ptr<ThreadPool> expansionPool() const;
+
+  // Soft delete support. When db_ stores tombstones the deleted events live
+  // there and only their IDs are kept here; otherwise the event is kept in
+  // memory. Either way the index is bounded by tombstoneTtl_ and
+  // maxTombstones_. Edited under mutex_ and indexMutex_ (exclusive).
+  using TombstoneOrder = std::multimap<std::chrono::system_clock::time_point, std::string>;
+  struct Tombstone
+  {
+    TombstoneOrder::iterator order;
+    EventPtr event; // null when db_ holds the body
+  };
+  // Deletion time -> ID, oldest first, for expiry
+  TombstoneOrder tombstoneOrder_;
+  std::unordered_map<std::string, Tombstone> tombstones_;
+  bool diskTombstones_ = false;
+  std::chrono::system_clock::duration tombstoneTtl_ = std::chrono::hours(24 * 30);
+  size_t maxTombstones_ = 100000;
+
+  // Record a tombstone for `e`, superseding any older one with its ID.
+  void addTombstoneLocked(const EventPtr &e, std::chrono::system_clock::time_point deletedAt);
+  void eraseTombstoneLocked(std::unordered_map<std::string, Tombstone>::iterator it);
+  // Drop tombstones past the TTL or the count bound. Caller holds mutex_
+  // and indexMutex_ exclusively.
+  void compactTombstonesLocked(std::chrono::system_clock::time_point now);
+  // Tombstones deleted before this are expired, purged or not
+  std::chrono::system_clock::time_point tombstoneCutoff(std::chrono::system_clock::time_point now) const;
 
   // Check if an event ID already exists in the current list
   bool eventExists(const std::string &id) const;
 
+  // Index-aware edits against a draft snapshot, recorded in changes_.
+  // Caller must hold mutex_ and indexMutex_ exclusively; publishLocked()
+  // makes the draft visible.
+  void insertLocked(EventSnapshot::Builder &draft, EventPtr e);
+  void eraseLocked(EventSnapshot::Builder &draft, EventPtr e);
+  void replaceLocked(EventSnapshot::Builder &draft, const EventPtr &current, EventPtr next);
+  void indexLocked(const EventPtr &e);
+  void unindexLocked(const EventPtr &e);
+  // Make a stored event resident (startup, paging) without recording a change
+  void admitLocked(EventSnapshot::Builder &draft, EventPtr e);
+  void publishLocked(EventSnapshot::Builder &draft);
+
+  // Paging: make resident the one-time events starting in [start, end),
+  // those that could overlap it, the first `n` starting at or after
+  // `from`, or the event with this ID. No-ops when not paging. Must not be
+  // called with mutex_ or indexMutex_ held.
+  void faultIn(std::chrono::system_clock::time_point start,
+               std::chrono::system_clock::time_point end) const;
+  void faultInOverlapping(std::chrono::system_clock::time_point start,
+                          std::chrono::system_clock::time_point end) const;
+  void faultInNext(std::chrono::system_clock::time_point from, size_t n) const;
+  void faultInId(const std::string &id) const;
+  // Caller holds mutex_.
+  void loadLocked(std::vector<std::unique_ptr<Event>> rows) const;
+  // Parts of [start, end) whose one-time events are not resident yet;
+  // none when not paging
+  std::vector<std::pair<std::chrono::system_clock::time_point, std::chrono::system_clock::time_point>>
+  unloadedGapsLocked(std::chrono::system_clock::time_point start, std::chrono::system_clock::time_point end) const;
+  void markLoadedLocked(std::chrono::system_clock::time_point start,
+                        std::chrono::system_clock::time_point end) const;
+
+  // Remove every event starting in [start, end) as one range: one pass
+  // over the snapshot, one database delete, one provider sync. When
+  // paging, stored rows that are not resident are deleted without being
+  // loaded; they are only read if a provider has to be told about them.
+  int removeEventsInRange(std::chrono::system_clock::time_point start,
+                          std::chrono::system_clock::time_point end);
+
+  // Store the provider IDs a bulk sync returned for these events, under
+  // one lock and one database batch. Empty IDs are left alone. False, with
+  // nothing recorded, if the database batch fails.
+  bool recordProviderIds(const std::vector<std::pair<std::string, ProviderIds>> &ids);
+
+  // Event::Field bits that differ between two versions of an event, for
+  // writing back only those columns; all of them for a series.
+  static uint16_t changedFields(const Event &before, const Event &after);
+
+  // [start, end) an event can occupy: first start to last occurrence end.
+  static std::pair<std::chrono::system_clock::time_point, std::chrono::system_clock::time_point>
+  conflictSpan(const Event &e);
+
+  // Append up to `limit` events/occurrences overlapping [start, end).
+  // Caller must hold indexMutex_ (shared is enough).
+  void collectConflictsLocked(std::chrono::system_clock::time_point start,
+                              std::chrono::system_clock::time_point end,
+                              size_t limit,
+                              std::vector<Event> &out) const;
+
 public:
-  // Construct with an initial list of events and optional database.
+  // Load events from an optional database. With preloadDaysAhead < 0 the
+  // whole table is loaded. Otherwise only recurring series and one-time
+  // events within preloadDaysAhead days of now are loaded; queries reaching
+  // beyond that load what they need from the database as they go. Queries
+  // without a time bound (search, category, duration) load the rest of the
+  // table the first time they run.
   explicit Model(IScheduleDatabase *db = nullptr,
                  int preloadDaysAhead = -1);
 
+  // Current immutable view of the schedule in time order. Cheap to take and
+  // safe to hold while writers keep going.
+  std::shared_ptr<const EventSnapshot> snapshot() const;
+
   // ReadOnlyModel overrides (note the const):
   std::vector<Event>
   getEvents(int maxOccurrences,
@@ -96,9 +240,40 @@ public:
   // Get events by category
   std::vector<Event> getEventsByCategory(const std::string &category) const;
 
-  // Get all categories
+  // ====== Borrowed results ======
+  // Same queries, returning the stored events themselves instead of copies.
+  // Expanded occurrences are freshly allocated; everything else is shared
+  // with the model and stays valid however the model changes afterwards.
+
+  std::vector<EventPtr> getEventPtrs(int maxOccurrences,
+                                     std::chrono::system_clock::time_point endDate) const;
+  std::vector<EventPtr> searchEventPtrs(const std::string &query, int maxResults = -1) const;
+  std::vector<EventPtr> getEventPtrsInRange(std::chrono::system_clock::time_point start,
+                                            std::chrono::system_clock::time_point end) const;
+  std::vector<EventPtr> getEventPtrsInRangeExpanded(std::chrono::system_clock::time_point start,
+                                                    std::chrono::system_clock::time_point end,
+                                                    int maxOccurrencesPerSeries = 10000) const;
+  std::vector<EventPtr> getEventPtrsByDuration(int minMinutes, int maxMinutes) const;
+  std::vector<EventPtr> getEventPtrsByCategory(const std::string &category) const;
+
+  // ====== Expanded schedules ======
+  // One Occurrence per one-time event or recurring instance, in start order.
+  // Text is read from the shared series on demand rather than copied.
+
+  std::vector<Occurrence> getNextOccurrences(int n) const;
+  std::vector<Occurrence> getOccurrencesOnDay(std::chrono::system_clock::time_point day) const;
+  std::vector<Occurrence> getOccurrencesInWeek(std::chrono::system_clock::time_point day) const;
+  std::vector<Occurrence> getOccurrencesInMonth(std::chrono::system_clock::time_point day) const;
+  std::vector<Occurrence> getOccurrencesInRange(std::chrono::system_clock::time_point start,
+                                                std::chrono::system_clock::time_point end,
+                                                int maxOccurrencesPerSeries = 10000) const;
+
+  // Get all categories that currently have at least one event
   std::set<std::string> getCategories() const;
 
+  // Live number of events filed under each category
+  std::map<std::string, size_t> getCategoryCounts() const;
+
   // Check for conflicts at a given time
   std::vector<Event> getConflicts(
       std::chrono::system_clock::time_point time,
@@ -123,8 +298,40 @@ public:
       std::chrono::system_clock::time_point start,
       std::chrono::system_clock::time_point end) const;
 
-  // Get deleted events (soft delete)
-  std::vector<Event> getDeletedEvents() const;
+  // Delta sync: what changed after version `since`. When the change log no
+  // longer reaches back that far, `resync` is set and the caller should
+  // fetch everything again. Upserts carry each event's current state; an ID
+  // changed several times appears once, under its latest change.
+  struct ChangeSet
+  {
+    uint64_t version = 0; // pass back as `since` next time
+    bool resync = false;
+    std::vector<EventPtr> upserts;
+    std::vector<std::string> deletes;
+  };
+  ChangeSet getChangesSince(uint64_t since) const;
+
+  // Version of the latest change, for pairing with a full fetch
+  uint64_t changeVersion() const;
+
+  // Get soft-deleted events in (time, id) order, `limit` at a time from
+  // `offset` (0 = no limit)
+  std::vector<Event> getDeletedEvents(size_t offset = 0, size_t limit = 0) const;
+
+  // How long soft-deleted events stay restorable, and how many are kept at
+  // most; beyond either the oldest deletions are purged
+  void setTombstoneRetention(std::chrono::system_clock::duration ttl, size_t maxTombstones);
+
+  // Purge expired tombstones now rather than at the next soft delete.
+  // Expired ones are neither listed nor restorable even before this runs.
+  void compactTombstones();
+
+  // Range queries whose estimated work (recurring series reaching into the
+  // window times the days it spans) is at least `threshold` expand their
+  // series on `threads` workers and merge the sorted runs in parallel.
+  // 0 keeps every query on the calling thread.
+  static constexpr size_t kDefaultParallelThreshold = 200000;
+  void setParallelExpansion(size_t threshold, size_t threads = std::thread::hardware_concurrency());
 
   // Get event by ID
   std::unique_ptr<Event> getEventById(const std::string &id) const;
@@ -164,19 +371,31 @@ public:
 
   // ====== Bulk Operations ======
 
-  // Add multiple events at once
+  // The bulk operations validate the whole batch first, then apply it
+  // under one lock, write it to the database as one batch and sync it to
+  // each calendar API in one call. Results are per item, as for the
+  // single-event methods, except that if the database batch fails nothing
+  // is applied and every item fails.
+
+  // Add multiple events at once; an ID already present (or repeated in the
+  // batch) fails
   std::vector<bool> addEvents(const std::vector<Event> &events);
 
   // Remove multiple events by ID
   int removeEvents(const std::vector<std::string> &ids);
 
-  // Update multiple events
+  // Update multiple events; later updates to the same ID apply on top of
+  // earlier ones
   std::vector<bool> updateEvents(
       const std::vector<std::pair<std::string, Event>> &updates);
 
-  // Generate a unique ID not currently in use
+  // Generate a new, time-ordered ID (see IdGenerator); never reused
   std::string generateUniqueId() const;
 
+  // Block until every change made so far has reached durable storage.
+  // False if the store had to drop some of them.
+  bool flush();
+
   // Register an external calendar API to mirror changes
   void addCalendarApi(std::shared_ptr<CalendarApi> api);
 
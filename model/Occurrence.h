@@ -0,0 +1,33 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include "Event.h"
+
+/*
+  One entry of an expanded schedule: either a one-time event or a single
+  occurrence of a recurring series. It only records where the entry starts
+  and which stored event it came from; title, description, category and
+  duration are read from `series` when needed, so expanding a long series
+  costs one small record per occurrence rather than a full Event copy.
+*/
+struct Occurrence
+{
+    std::shared_ptr<const Event> series;
+    std::chrono::system_clock::time_point start;
+    // Position among this series' occurrences in the expansion that produced
+    // it (0 for one-time events).
+    uint32_t index = 0;
+
+    const Event &event() const { return *series; }
+    std::chrono::system_clock::time_point end() const { return start + series->getDuration(); }
+
+    // Standalone Event for this occurrence, for callers that need a copy.
+    Event materialize() const
+    {
+        Event copy = *series;
+        copy.setTime(start);
+        return copy;
+    }
+};
@@ -0,0 +1,106 @@
+#include "OccurrenceCache.h"
+#include <algorithm>
+
+OccurrenceCache::OccurrenceCache(std::chrono::system_clock::duration horizon)
+    : horizon_(horizon)
+{
+}
+
+bool OccurrenceCache::expand(const RecurrencePattern &pattern, TimePoint start, TimePoint end,
+                             std::vector<TimePoint> &out)
+{
+    for (auto t : pattern.occurrencesBetween(start, end))
+    {
+        if (out.size() >= kMaxCached)
+            return false;
+        out.push_back(t);
+    }
+    return true;
+}
+
+bool OccurrenceCache::tooWide(TimePoint from, TimePoint until) const
+{
+    // Any span covering one that overflowed holds at least as many
+    return hasTooWide_ && from <= tooWideFrom_ && tooWideUntil_ <= until;
+}
+
+void OccurrenceCache::markTooWide(TimePoint from, TimePoint until)
+{
+    // Keep the narrower witness; it rules out more spans
+    if (!hasTooWide_ || until - from < tooWideUntil_ - tooWideFrom_)
+    {
+        hasTooWide_ = true;
+        tooWideFrom_ = from;
+        tooWideUntil_ = until;
+    }
+}
+
+bool OccurrenceCache::lookup(const RecurrencePattern &pattern, TimePoint start, TimePoint end, Slice &out)
+{
+    if (end == TimePoint::max() || start == TimePoint::min())
+        return false;
+    if (end <= start)
+    {
+        out = Slice();
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!times_ || start < from_)
+    {
+        // Fill, or refill reaching further back, around now
+        if (!anchored_)
+        {
+            anchor_ = std::chrono::system_clock::now();
+            anchored_ = true;
+        }
+        TimePoint from = std::min(start, anchor_ - horizon_);
+        TimePoint until = std::max(end, anchor_ + horizon_);
+        if (times_)
+        {
+            from = std::min(from, from_);
+            until = std::max(until, until_);
+        }
+        if (tooWide(from, until))
+            return false;
+        auto times = std::make_shared<std::vector<TimePoint>>();
+        if (!expand(pattern, from, until, *times))
+        {
+            markTooWide(from, until);
+            return false;
+        }
+        times_ = std::move(times);
+        from_ = from;
+        until_ = until;
+    }
+    else if (end > until_)
+    {
+        // Past the horizon: carry on from where the array stops
+        TimePoint until = until_ < TimePoint::max() - horizon_ ? until_ + horizon_ : TimePoint::max();
+        until = std::max(end, until);
+        if (tooWide(from_, until))
+            return false;
+        // Append in place unless a slice still reads the array; then copy
+        // it once into one with room to grow
+        if (times_.use_count() > 1)
+        {
+            auto times = std::make_shared<std::vector<TimePoint>>();
+            times->reserve(std::min(kMaxCached, times_->size() * 2));
+            times->assign(times_->begin(), times_->end());
+            times_ = std::move(times);
+        }
+        size_t cached = times_->size();
+        if (!expand(pattern, until_, until, *times_))
+        {
+            times_->resize(cached);
+            markTooWide(from_, until);
+            return false;
+        }
+        until_ = until;
+    }
+
+    out.times_ = times_;
+    out.first_ = static_cast<size_t>(std::lower_bound(times_->begin(), times_->end(), start) - times_->begin());
+    out.last_ = static_cast<size_t>(std::lower_bound(times_->begin() + out.first_, times_->end(), end) - times_->begin());
+    return true;
+}
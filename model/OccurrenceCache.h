@@ -0,0 +1,78 @@
+#pragma once
+
+#include "recurrence/RecurrencePattern.h"
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/*
+  Sorted occurrence times of one recurring series, kept around a rolling
+  horizon so the calendar views' repeated day, week and month queries are a
+  binary search instead of a fresh expansion. The first lookup caches the
+  occurrences from `horizon` before now to `horizon` after it, widened to
+  the query; a later query past either end extends the array, forward in
+  place unless a Slice still holds it. Unbounded windows, and ones that
+  would grow the array past kMaxCached, are left to the caller to expand
+  directly; the cache remembers such a span so it does not expand it
+  again.
+
+  Patterns never change, so a cache stays valid for as long as its series
+  keeps the pattern; RecurringEvent starts a new one when the pattern is
+  replaced. Safe to share between threads.
+*/
+class OccurrenceCache
+{
+public:
+    using TimePoint = std::chrono::system_clock::time_point;
+
+    static constexpr size_t kMaxCached = 16384;
+
+    // Occurrences of a lookup, in start order. Holds the array it points
+    // into, so it stays valid after the cache moves on.
+    class Slice
+    {
+    public:
+        const TimePoint *begin() const { return times_ ? times_->data() + first_ : nullptr; }
+        const TimePoint *end() const { return times_ ? times_->data() + last_ : nullptr; }
+        size_t size() const { return last_ - first_; }
+        bool empty() const { return first_ == last_; }
+
+    private:
+        friend class OccurrenceCache;
+        std::shared_ptr<const std::vector<TimePoint>> times_;
+        size_t first_ = 0;
+        size_t last_ = 0;
+    };
+
+    explicit OccurrenceCache(std::chrono::system_clock::duration horizon = std::chrono::hours(24 * 90));
+
+    // Occurrences of `pattern` in [start, end). False when the window is not
+    // worth caching; `out` is then untouched.
+    bool lookup(const RecurrencePattern &pattern, TimePoint start, TimePoint end, Slice &out);
+
+private:
+    // Occurrences in [start, end) appended to `out`; false past kMaxCached
+    static bool expand(const RecurrencePattern &pattern, TimePoint start, TimePoint end, std::vector<TimePoint> &out);
+
+    // Whether caching [from, until) is known to exceed kMaxCached
+    bool tooWide(TimePoint from, TimePoint until) const;
+    void markTooWide(TimePoint from, TimePoint until);
+
+    std::chrono::system_clock::duration horizon_;
+    std::mutex mutex_;
+    // "Now" as of the first lookup; the horizon stays centred on it so a
+    // repeated query asks for the same span
+    bool anchored_ = false;
+    TimePoint anchor_{};
+    // Every occurrence in [from_, until_), once filled. Only the cache
+    // writes to it, and only while no Slice shares it.
+    std::shared_ptr<std::vector<TimePoint>> times_;
+    TimePoint from_{};
+    TimePoint until_{};
+    // A span holding more than kMaxCached occurrences, once one is found
+    bool hasTooWide_ = false;
+    TimePoint tooWideFrom_{};
+    TimePoint tooWideUntil_{};
+};
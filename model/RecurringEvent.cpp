@@ -10,26 +10,17 @@ RecurringEvent::RecurringEvent(const std::string &id,
                                std::shared_ptr<RecurrencePattern> recurrencePattern,
                                const std::string &category)
     : Event(id, desc, title, time, duration, category),
-      recurrencePattern(std::move(recurrencePattern))
+      recurrencePattern(std::move(recurrencePattern)),
+      occurrenceCache(std::make_shared<OccurrenceCache>())
 {
     setRecurring(true);
 }
 
 std::unique_ptr<Event> RecurringEvent::clone() const
 {
-    auto ptr = std::make_unique<RecurringEvent>(
-        getId(),
-        getDescription(),
-        getTitle(),
-        getTime(),
-        getDuration(),
-        recurrencePattern, // Share the recurrence pattern
-        getCategory());
-    ptr->setNotifierName(getNotifierName());
-    ptr->setActionName(getActionName());
-    ptr->setProviderEventId(getProviderEventId());
-    ptr->setProviderTaskId(getProviderTaskId());
-    return ptr;
+    // Copying carries the interned handles over without touching the pool
+    // and shares the recurrence pattern
+    return std::make_unique<RecurringEvent>(*this);
 }
 
 bool RecurringEvent::isDueOn(std::chrono::system_clock::time_point date) const
@@ -42,3 +33,16 @@ RecurringEvent::getNextNOccurrences(std::chrono::system_clock::time_point after,
 {
     return recurrencePattern->getNextNOccurrences(after, n);
 }
+
+OccurrenceRange RecurringEvent::occurrencesBetween(std::chrono::system_clock::time_point start,
+                                                   std::chrono::system_clock::time_point end) const
+{
+    return recurrencePattern->occurrencesBetween(start, end);
+}
+
+bool RecurringEvent::cachedOccurrences(std::chrono::system_clock::time_point start,
+                                       std::chrono::system_clock::time_point end,
+                                       OccurrenceCache::Slice &out) const
+{
+    return recurrencePattern && occurrenceCache->lookup(*recurrencePattern, start, end, out);
+}
@@ -2,6 +2,7 @@
 #pragma once
 
 #include "Event.h"
+#include "OccurrenceCache.h"
 #include "recurrence/RecurrencePattern.h"
 #include <memory>
 #include <vector>
@@ -12,6 +13,8 @@ class RecurringEvent : public Event
 {
 private:
     std::shared_ptr<RecurrencePattern> recurrencePattern;
+    // Shared by clones, which keep the pattern; replaced along with it
+    std::shared_ptr<OccurrenceCache> occurrenceCache;
 
 public:
     // Constructor with optional category
@@ -33,6 +36,16 @@ public:
     std::vector<std::chrono::system_clock::time_point> getNextNOccurrences(
         std::chrono::system_clock::time_point after, int n) const;
 
+    // Occurrences starting in [start, end), generated as the loop advances
+    OccurrenceRange occurrencesBetween(std::chrono::system_clock::time_point start,
+                                       std::chrono::system_clock::time_point end) const;
+
+    // Occurrences in [start, end) from the series' cache. False when the
+    // window is not cached, in which case use occurrencesBetween().
+    bool cachedOccurrences(std::chrono::system_clock::time_point start,
+                           std::chrono::system_clock::time_point end,
+                           OccurrenceCache::Slice &out) const;
+
     // Get the recurrence pattern
     std::shared_ptr<RecurrencePattern> getRecurrencePattern() const
     {
@@ -43,5 +56,6 @@ public:
     void setRecurrencePattern(std::shared_ptr<RecurrencePattern> pattern)
     {
         recurrencePattern = std::move(pattern);
+        occurrenceCache = std::make_shared<OccurrenceCache>();
     }
 };
@@ -0,0 +1,256 @@
+#include "SearchIndex.h"
+#include "Event.h"
+#include "../utils/EditDistance.h"
+#include <algorithm>
+
+namespace
+{
+    bool isSpace(unsigned char c)
+    {
+        return c == ' ' || (c >= '\t' && c <= '\r');
+    }
+} // namespace
+
+std::vector<std::string> SearchIndex::tokenize(const std::string &text)
+{
+    std::vector<std::string> tokens;
+    std::string current;
+    for (char raw : text)
+    {
+        auto c = static_cast<unsigned char>(raw);
+        if (c >= 'A' && c <= 'Z')
+            c = static_cast<unsigned char>(c - 'A' + 'a');
+        if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9'))
+        {
+            current += static_cast<char>(c);
+        }
+        else if (isSpace(c) && !current.empty())
+        {
+            tokens.push_back(std::move(current));
+            current.clear();
+        }
+        // Punctuation is dropped without splitting the word ("o'clock" -> "oclock")
+    }
+    if (!current.empty())
+        tokens.push_back(std::move(current));
+    return tokens;
+}
+
+uint32_t SearchIndex::trigramKey(const std::string &s, size_t pos)
+{
+    return (static_cast<uint32_t>(static_cast<unsigned char>(s[pos])) << 16) |
+           (static_cast<uint32_t>(static_cast<unsigned char>(s[pos + 1])) << 8) |
+           static_cast<uint32_t>(static_cast<unsigned char>(s[pos + 2]));
+}
+
+SearchIndex::CharCounts SearchIndex::countChars(const std::string &s)
+{
+    CharCounts counts{};
+    for (char c : s)
+        ++counts[c >= 'a' ? static_cast<size_t>(c - 'a') : static_cast<size_t>(26 + c - '0')];
+    return counts;
+}
+
+SearchIndex::TokenId SearchIndex::acquire(const std::string &text)
+{
+    auto found = tokenIds_.find(text);
+    if (found != tokenIds_.end())
+        return found->second;
+
+    TokenId id;
+    if (!freeIds_.empty())
+    {
+        id = freeIds_.back();
+        freeIds_.pop_back();
+    }
+    else
+    {
+        id = static_cast<TokenId>(tokens_.size());
+        tokens_.emplace_back();
+    }
+    Token &token = tokens_[id];
+    token.text = text;
+    token.counts = countChars(text);
+    tokenIds_.emplace(text, id);
+    for (size_t i = 0; i + 3 <= text.size(); ++i)
+        trigrams_[trigramKey(text, i)].insert(id);
+    if (byLength_.size() <= text.size())
+        byLength_.resize(text.size() + 1);
+    byLength_[text.size()].insert(id);
+    return id;
+}
+
+void SearchIndex::release(TokenId id)
+{
+    Token &token = tokens_[id];
+    const std::string &text = token.text;
+    for (size_t i = 0; i + 3 <= text.size(); ++i)
+    {
+        auto list = trigrams_.find(trigramKey(text, i));
+        if (list == trigrams_.end())
+            continue;
+        list->second.erase(id);
+        if (list->second.empty())
+            trigrams_.erase(list);
+    }
+    byLength_[text.size()].erase(id);
+    tokenIds_.erase(text);
+    token = Token();
+    freeIds_.push_back(id);
+}
+
+void SearchIndex::insert(const Event *event)
+{
+    auto words = tokenize(event->getTitle());
+    auto more = tokenize(event->getDescription());
+    words.insert(words.end(), std::make_move_iterator(more.begin()), std::make_move_iterator(more.end()));
+
+    std::vector<TokenId> ids;
+    ids.reserve(words.size());
+    for (const auto &w : words)
+        ids.push_back(acquire(w));
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+    for (TokenId id : ids)
+        tokens_[id].events.insert(event);
+    eventTokens_[event] = std::move(ids);
+}
+
+void SearchIndex::erase(const Event *event)
+{
+    auto found = eventTokens_.find(event);
+    if (found == eventTokens_.end())
+        return;
+    for (TokenId id : found->second)
+    {
+        tokens_[id].events.erase(event);
+        if (tokens_[id].events.empty())
+            release(id);
+    }
+    eventTokens_.erase(found);
+}
+
+void SearchIndex::clear()
+{
+    tokens_.clear();
+    freeIds_.clear();
+    tokenIds_.clear();
+    trigrams_.clear();
+    byLength_.clear();
+    eventTokens_.clear();
+}
+
+std::vector<char> SearchIndex::matchingTokens(const std::string &q) const
+{
+    std::vector<char> mask(tokens_.size(), 0);
+    const size_t lq = q.size();
+
+    // Substring: a word containing q contains every trigram of q, so the
+    // rarest trigram's list is a complete candidate set.
+    if (lq >= 3)
+    {
+        const std::unordered_set<TokenId> *rarest = nullptr;
+        for (size_t i = 0; i + 3 <= lq; ++i)
+        {
+            auto list = trigrams_.find(trigramKey(q, i));
+            if (list == trigrams_.end())
+            {
+                rarest = nullptr;
+                break;
+            }
+            if (!rarest || list->second.size() < rarest->size())
+                rarest = &list->second;
+        }
+        if (rarest)
+        {
+            for (TokenId id : *rarest)
+                if (tokens_[id].text.find(q) != std::string::npos)
+                    mask[id] = 1;
+        }
+    }
+    else
+    {
+        for (size_t len = lq; len < byLength_.size(); ++len)
+            for (TokenId id : byLength_[len])
+                if (tokens_[id].text.find(q) != std::string::npos)
+                    mask[id] = 1;
+    }
+
+    // Fuzzy: similarity >= 0.5 means 2 * distance <= max length. The distance
+    // is at least the length difference and at least max length minus the
+    // characters the two words share, so words failing either bound are skipped.
+    const BoundedEditDistance kernel(q);
+    const CharCounts qCounts = countChars(q);
+    const size_t minLen = (lq + 1) / 2;
+    const size_t maxLen = std::min(2 * lq, byLength_.empty() ? size_t(0) : byLength_.size() - 1);
+    for (size_t len = minLen; len <= maxLen; ++len)
+    {
+        const size_t longest = std::max(lq, len);
+        for (TokenId id : byLength_[len])
+        {
+            if (mask[id])
+                continue;
+            const Token &token = tokens_[id];
+            size_t shared = 0;
+            for (size_t c = 0; c < qCounts.size(); ++c)
+                shared += std::min(qCounts[c], token.counts[c]);
+            if (2 * (longest - shared) > longest)
+                continue;
+            if (kernel.within(token.text, longest / 2))
+                mask[id] = 1;
+        }
+    }
+    return mask;
+}
+
+std::vector<const Event *> SearchIndex::match(const std::vector<std::string> &queryTokens) const
+{
+    std::vector<const Event *> results;
+    if (queryTokens.empty())
+        return results;
+
+    std::vector<std::vector<char>> masks;
+    masks.reserve(queryTokens.size());
+    size_t seed = 0;
+    size_t seedPostings = SIZE_MAX;
+    for (size_t i = 0; i < queryTokens.size(); ++i)
+    {
+        masks.push_back(matchingTokens(queryTokens[i]));
+        size_t postings = 0;
+        for (TokenId id = 0; id < masks[i].size(); ++id)
+            if (masks[i][id])
+                postings += tokens_[id].events.size();
+        if (postings == 0)
+            return results;
+        if (postings < seedPostings)
+        {
+            seed = i;
+            seedPostings = postings;
+        }
+    }
+
+    // Candidates come from the most selective query token; each is then
+    // checked against the others through its own word list.
+    std::unordered_set<const Event *> candidates;
+    candidates.reserve(seedPostings);
+    for (TokenId id = 0; id < masks[seed].size(); ++id)
+        if (masks[seed][id])
+            candidates.insert(tokens_[id].events.begin(), tokens_[id].events.end());
+
+    for (const Event *event : candidates)
+    {
+        const auto &words = eventTokens_.at(event);
+        bool all = true;
+        for (size_t i = 0; i < masks.size() && all; ++i)
+        {
+            if (i == seed)
+                continue;
+            all = std::any_of(words.begin(), words.end(), [&](TokenId id)
+                              { return masks[i][id] != 0; });
+        }
+        if (all)
+            results.push_back(event);
+    }
+    return results;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class Event;
+
+/*
+  Inverted index behind Model::searchEvents.
+  Title and description are normalized (lowercase, only [a-z0-9] kept) and
+  split into tokens once, when an event is indexed. Each distinct token is
+  stored once in a vocabulary with the events that contain it, so a query
+  works on distinct words rather than on every event.
+
+  A query token q matches a word w when w contains q, or when
+  similarity(q, w) = 1 - levenshtein(q, w) / max(|q|, |w|) is at least 0.5.
+  Substring candidates come from a trigram index over the vocabulary. Fuzzy
+  candidates come from words whose length is within a factor of two of q and
+  whose character counts are close enough to q's; both are lower bounds on
+  the edit distance, so nothing that could match is skipped. What is left
+  goes through BoundedEditDistance with a cutoff of max(|q|, |w|) / 2.
+*/
+class SearchIndex
+{
+public:
+    SearchIndex() = default;
+    SearchIndex(const SearchIndex &) = delete;
+    SearchIndex &operator=(const SearchIndex &) = delete;
+
+    void insert(const Event *event);
+    void erase(const Event *event);
+    void clear();
+
+    // Lowercase and drop everything but [a-z0-9] and whitespace, then split
+    // on whitespace.
+    static std::vector<std::string> tokenize(const std::string &text);
+
+    // Events where every query token matches some word of the title or
+    // description. Unordered. `queryTokens` must come from tokenize() and
+    // must not be empty.
+    std::vector<const Event *> match(const std::vector<std::string> &queryTokens) const;
+
+    size_t vocabularySize() const { return tokenIds_.size(); }
+
+private:
+    using TokenId = uint32_t;
+    using CharCounts = std::array<uint32_t, 36>; // a-z then 0-9
+
+    struct Token
+    {
+        std::string text;
+        CharCounts counts{};
+        std::unordered_set<const Event *> events;
+    };
+
+    std::vector<Token> tokens_;
+    std::vector<TokenId> freeIds_;
+    std::unordered_map<std::string, TokenId> tokenIds_;
+    std::unordered_map<uint32_t, std::unordered_set<TokenId>> trigrams_;
+    std::vector<std::unordered_set<TokenId>> byLength_;
+    std::unordered_map<const Event *, std::vector<TokenId>> eventTokens_;
+
+    TokenId acquire(const std::string &text);
+    void release(TokenId id);
+    // Vocabulary words that query token `q` matches, as a membership mask
+    // over token ids.
+    std::vector<char> matchingTokens(const std::string &q) const;
+
+    static uint32_t trigramKey(const std::string &s, size_t pos);
+    static CharCounts countChars(const std::string &s);
+};
@@ -1,4 +1,7 @@
 #include "DailyRecurrence.h"
+#include "../../utils/CivilDate.h"
+#include <algorithm>
+#include <limits>
 
 DailyRecurrence::DailyRecurrence(
     chrono::system_clock::time_point start,
@@ -12,43 +15,33 @@ DailyRecurrence::DailyRecurrence(
 {
 }
 
-vector<chrono::system_clock::time_point> DailyRecurrence::getNextNOccurrences(
-    chrono::system_clock::time_point after, int n) const
+long long DailyRecurrence::occurrenceSeconds(long long index) const
 {
-    vector<chrono::system_clock::time_point> result;
-    if (n <= 0)
-    {
-        return result;
-    }
-
-    auto dayDur = chrono::hours(24 * repeatingInterval);
+    long long step = std::max(1, repeatingInterval) * CivilDate::kSecondsPerDay;
+    return CivilDate::split(startingPoint).seconds + index * step;
+}
 
-    // Determine the first occurrence index
-    long long index = 0;
-    if (after > startingPoint)
-    {
-        auto diff = after - startingPoint;
-        auto diffDays = chrono::duration_cast<chrono::hours>(diff).count() / 24;
-        index = diffDays / repeatingInterval + 1;
-    }
+long long DailyRecurrence::firstIndexAfter(chrono::system_clock::time_point t) const
+{
+    auto start = CivilDate::split(startingPoint);
+    auto target = CivilDate::split(t);
+    if (CivilDate::later(start.seconds, start.frac, target))
+        return 0;
+    long long step = std::max(1, repeatingInterval) * CivilDate::kSecondsPerDay;
+    long long index = (target.seconds - start.seconds) / step;
+    return CivilDate::later(occurrenceSeconds(index), start.frac, target) ? index : index + 1;
+}
 
-    int occurrencesGenerated = 0;
-    while (occurrencesGenerated < n)
-    {
-        auto nextTime = startingPoint + dayDur * index;
-        if (nextTime > endDate)
-            break;
-        if (maxOccurrences != -1 && index >= maxOccurrences)
-            break;
-        if (nextTime > after)
-        {
-            result.push_back(nextTime);
-            ++occurrencesGenerated;
-        }
-        ++index;
-    }
+long long DailyRecurrence::indexLimit() const
+{
+    long long limit = maxOccurrences == -1 ? std::numeric_limits<long long>::max()
+                                           : std::max(0, maxOccurrences);
+    return std::min(limit, firstIndexAfter(endDate));
+}
 
-    return result;
+chrono::system_clock::duration DailyRecurrence::occurrenceFraction() const
+{
+    return CivilDate::split(startingPoint).frac;
 }
 
 bool DailyRecurrence::isDueOn(chrono::system_clock::time_point date) const
@@ -70,4 +63,23 @@ bool DailyRecurrence::isDueOn(chrono::system_clock::time_point date) const
         return false;
     }
     return true;
-}
\ No newline at end of file
+}
+
+chrono::system_clock::time_point DailyRecurrence::lastOccurrenceBound() const
+{
+    if (maxOccurrences == -1)
+    {
+        return endDate;
+    }
+    long long limit = indexLimit();
+    if (limit <= 0)
+    {
+        return startingPoint;
+    }
+    chrono::system_clock::time_point last;
+    if (!occurrenceAt(limit - 1, last))
+    {
+        return chrono::system_clock::time_point::max();
+    }
+    return last;
+}
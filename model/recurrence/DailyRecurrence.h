@@ -1,4 +1,4 @@
-#include "RecurrencePattern.h"
+#include "IndexedRecurrence.h"
 #include <chrono>
 #include <vector>
 #include <string>
@@ -7,7 +7,7 @@
 // Use `DailyRecurrence` when an activity follows a simple daily cadence.
 // Example: every 7 days I want to order Nandos.
 // Example: every other day I want to go to the gym.
-class DailyRecurrence : public RecurrencePattern
+class DailyRecurrence : public IndexedRecurrence
 {
 private:
     // First date/time of the recurrence (UTC)
@@ -21,10 +21,8 @@ public:
                     int maxOccurrences = -1,
                     chrono::system_clock::time_point endDate = chrono::system_clock::time_point::max());
 
-    std::vector<chrono::system_clock::time_point> getNextNOccurrences(
-        chrono::system_clock::time_point after, int n) const override;
-
     bool isDueOn(chrono::system_clock::time_point date) const override;
+    chrono::system_clock::time_point lastOccurrenceBound() const override;
 
     std::string type() const override { return "daily"; }
     int getInterval() const { return repeatingInterval; }
@@ -32,4 +30,10 @@ public:
     chrono::system_clock::time_point getEndDate() const { return endDate; }
 
     ~DailyRecurrence() override = default;
+
+protected:
+    long long occurrenceSeconds(long long index) const override;
+    chrono::system_clock::duration occurrenceFraction() const override;
+    long long firstIndexAfter(chrono::system_clock::time_point t) const override;
+    long long indexLimit() const override;
 };
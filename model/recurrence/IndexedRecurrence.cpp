@@ -0,0 +1,58 @@
+#include "IndexedRecurrence.h"
+#include "../../utils/CivilDate.h"
+
+class IndexedRecurrence::Cursor : public OccurrenceCursor
+{
+public:
+    Cursor(const IndexedRecurrence &pattern, long long index, long long limit)
+        : pattern_(pattern), index_(index), limit_(limit) {}
+
+    bool next(std::chrono::system_clock::time_point &out) override
+    {
+        if (index_ >= limit_ || !pattern_.occurrenceAt(index_, out))
+            return false;
+        ++index_;
+        return true;
+    }
+
+private:
+    const IndexedRecurrence &pattern_;
+    long long index_;
+    long long limit_;
+};
+
+bool IndexedRecurrence::occurrenceAt(long long index, std::chrono::system_clock::time_point &out) const
+{
+    long long seconds = occurrenceSeconds(index);
+    if (!CivilDate::representable(seconds))
+        return false;
+    out = CivilDate::join(seconds, occurrenceFraction());
+    return true;
+}
+
+std::vector<std::chrono::system_clock::time_point>
+IndexedRecurrence::getNextNOccurrences(std::chrono::system_clock::time_point after, int n) const
+{
+    std::vector<std::chrono::system_clock::time_point> result;
+    if (n <= 0)
+        return result;
+
+    long long limit = indexLimit();
+    std::chrono::system_clock::time_point t;
+    for (long long index = firstIndexAfter(after); index < limit && static_cast<int>(result.size()) < n; ++index)
+    {
+        if (!occurrenceAt(index, t))
+            break;
+        result.push_back(t);
+    }
+    return result;
+}
+
+std::unique_ptr<OccurrenceCursor> IndexedRecurrence::occurrencesFrom(std::chrono::system_clock::time_point from) const
+{
+    // At or after `from` is after the tick before it
+    long long first = from == std::chrono::system_clock::time_point::min()
+                          ? 0
+                          : firstIndexAfter(from - std::chrono::system_clock::duration(1));
+    return std::make_unique<Cursor>(*this, first, indexLimit());
+}
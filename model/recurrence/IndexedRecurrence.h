@@ -0,0 +1,34 @@
+#pragma once
+#include "RecurrencePattern.h"
+#include <chrono>
+#include <memory>
+#include <vector>
+
+// Base for patterns that can compute their Nth occurrence directly. Given
+// where occurrence N starts, the first one after any time and how many the
+// count and end date allow, it provides getNextNOccurrences and cursors
+// whose cost depends only on the occurrences they return.
+class IndexedRecurrence : public RecurrencePattern
+{
+public:
+    std::vector<std::chrono::system_clock::time_point> getNextNOccurrences(
+        std::chrono::system_clock::time_point after, int n) const override;
+
+    std::unique_ptr<OccurrenceCursor> occurrencesFrom(std::chrono::system_clock::time_point from) const override;
+
+protected:
+    // Whole seconds since the epoch of occurrence `index`
+    virtual long long occurrenceSeconds(long long index) const = 0;
+    // Sub-second part shared by every occurrence
+    virtual std::chrono::system_clock::duration occurrenceFraction() const = 0;
+    // Index of the first occurrence later than `t`
+    virtual long long firstIndexAfter(std::chrono::system_clock::time_point t) const = 0;
+    // One past the last index maxOccurrences and endDate allow
+    virtual long long indexLimit() const = 0;
+
+    // Start of occurrence `index`; false when it is past what a time_point holds
+    bool occurrenceAt(long long index, std::chrono::system_clock::time_point &out) const;
+
+private:
+    class Cursor;
+};
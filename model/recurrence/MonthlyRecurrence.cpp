@@ -1,41 +1,7 @@
 #include "MonthlyRecurrence.h"
+#include "../../utils/CivilDate.h"
 #include <algorithm>
-
-namespace {
-
-bool isLeap(int year) {
-    return (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
-}
-
-int daysInMonth(int year, int month) {
-    static const int days[] = {31,28,31,30,31,30,31,31,30,31,30,31};
-    if (month == 2)
-        return days[1] + (isLeap(year) ? 1 : 0);
-    return days[month-1];
-}
-
-std::tm to_tm(std::chrono::system_clock::time_point tp) {
-    time_t t = std::chrono::system_clock::to_time_t(tp);
-    std::tm tm_buf;
-#if defined(_MSC_VER)
-    gmtime_s(&tm_buf, &t);
-#else
-    gmtime_r(&t, &tm_buf);
-#endif
-    return tm_buf;
-}
-
-std::chrono::system_clock::time_point from_tm(const std::tm& tm_buf) {
-    std::tm temp = tm_buf;
-#if defined(_MSC_VER)
-    time_t t = _mkgmtime(&temp);
-#else
-    time_t t = timegm(&temp);
-#endif
-    return std::chrono::system_clock::from_time_t(t);
-}
-
-}
+#include <limits>
 
 MonthlyRecurrence::MonthlyRecurrence(std::chrono::system_clock::time_point start,
                                      int interval,
@@ -46,50 +12,40 @@ MonthlyRecurrence::MonthlyRecurrence(std::chrono::system_clock::time_point start
       maxOccurrences(max),
       endDate(endDate) {}
 
-std::vector<std::chrono::system_clock::time_point>
-MonthlyRecurrence::getNextNOccurrences(std::chrono::system_clock::time_point after, int n) const {
-    std::vector<std::chrono::system_clock::time_point> result;
-    if (n <= 0)
-        return result;
+long long MonthlyRecurrence::occurrenceSeconds(long long index) const {
+    int64_t startYear, timeOfDay;
+    int startMonth, startDay;
+    CivilDate::civilFromSeconds(CivilDate::split(startingPoint).seconds, startYear, startMonth, startDay, timeOfDay);
+    int64_t months = startYear * 12 + (startMonth - 1) + index * std::max(1, repeatingInterval);
+    int64_t year = CivilDate::floorDiv(months, 12);
+    int month = static_cast<int>(months - year * 12) + 1;
+    int day = std::min(startDay, CivilDate::daysInMonth(year, month));
+    return CivilDate::daysFromCivil(year, month, day) * CivilDate::kSecondsPerDay + timeOfDay;
+}
 
-    auto start_tm = to_tm(startingPoint);
-    long long index = 0;
-    // find first index with occurrence > after
-    while (true) {
-        std::tm cand_tm = start_tm;
-        int totalMonths = start_tm.tm_mon + index * repeatingInterval;
-        cand_tm.tm_year += totalMonths / 12;
-        cand_tm.tm_mon = totalMonths % 12;
-        int days = daysInMonth(cand_tm.tm_year + 1900, cand_tm.tm_mon + 1);
-        if (cand_tm.tm_mday > days)
-            cand_tm.tm_mday = days;
-        auto candidate = from_tm(cand_tm);
-        if (candidate > after || candidate > endDate)
-            break;
+long long MonthlyRecurrence::firstIndexAfter(std::chrono::system_clock::time_point t) const {
+    int64_t startYear, year, timeOfDay;
+    int startMonth, startDay, month, day;
+    CivilDate::civilFromSeconds(CivilDate::split(startingPoint).seconds, startYear, startMonth, startDay, timeOfDay);
+    auto target = CivilDate::split(t);
+    CivilDate::civilFromSeconds(target.seconds, year, month, day, timeOfDay);
+    // Occurrences before `index` fall in earlier months than t, so at most
+    // one more step is needed.
+    int64_t monthsIn = (year * 12 + month) - (startYear * 12 + startMonth);
+    long long index = std::max<int64_t>(0, CivilDate::floorDiv(monthsIn, std::max(1, repeatingInterval)));
+    while (!CivilDate::later(occurrenceSeconds(index), std::chrono::system_clock::duration::zero(), target))
         ++index;
-        if (maxOccurrences != -1 && index >= maxOccurrences)
-            return result;
-    }
+    return index;
+}
 
-    while (static_cast<int>(result.size()) < n) {
-        std::tm cand_tm = start_tm;
-        int totalMonths = start_tm.tm_mon + index * repeatingInterval;
-        cand_tm.tm_year += totalMonths / 12;
-        cand_tm.tm_mon = totalMonths % 12;
-        int days = daysInMonth(cand_tm.tm_year + 1900, cand_tm.tm_mon + 1);
-        if (cand_tm.tm_mday > days)
-            cand_tm.tm_mday = days;
-        auto candidate = from_tm(cand_tm);
-        if (candidate > endDate)
-            break;
-        if (maxOccurrences != -1 && index >= maxOccurrences)
-            break;
-        if (candidate > after)
-            result.push_back(candidate);
-        ++index;
-    }
+long long MonthlyRecurrence::indexLimit() const {
+    long long limit = maxOccurrences == -1 ? std::numeric_limits<long long>::max()
+                                           : std::max(0, maxOccurrences);
+    return std::min(limit, firstIndexAfter(endDate));
+}
 
-    return result;
+std::chrono::system_clock::duration MonthlyRecurrence::occurrenceFraction() const {
+    return std::chrono::system_clock::duration::zero();
 }
 
 bool MonthlyRecurrence::isDueOn(std::chrono::system_clock::time_point date) const {
@@ -97,3 +53,15 @@ bool MonthlyRecurrence::isDueOn(std::chrono::system_clock::time_point date) cons
     auto next = getNextNOccurrences(prev, 1);
     return !next.empty() && next.front() == date;
 }
+
+std::chrono::system_clock::time_point MonthlyRecurrence::lastOccurrenceBound() const {
+    if (maxOccurrences == -1)
+        return endDate;
+    long long limit = indexLimit();
+    if (limit <= 0)
+        return startingPoint;
+    std::chrono::system_clock::time_point last;
+    if (!occurrenceAt(limit - 1, last))
+        return std::chrono::system_clock::time_point::max();
+    return last;
+}
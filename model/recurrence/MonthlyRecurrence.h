@@ -1,5 +1,5 @@
 #pragma once
-#include "RecurrencePattern.h"
+#include "IndexedRecurrence.h"
 #include <chrono>
 #include <vector>
 #include <string>
@@ -8,7 +8,7 @@
 // Use `MonthlyRecurrence` when you need a monthly cadence where the day
 // of the month matters. For example, paying rent on the 1st of every month
 // or a meeting on the last day of the month.
-class MonthlyRecurrence : public RecurrencePattern {
+class MonthlyRecurrence : public IndexedRecurrence {
 private:
     std::chrono::system_clock::time_point startingPoint;
     int repeatingInterval;
@@ -20,10 +20,8 @@ public:
                       int maxOccurrences = -1,
                       std::chrono::system_clock::time_point endDate = std::chrono::system_clock::time_point::max());
 
-    std::vector<std::chrono::system_clock::time_point> getNextNOccurrences(
-        std::chrono::system_clock::time_point after, int n) const override;
-
     bool isDueOn(std::chrono::system_clock::time_point date) const override;
+    std::chrono::system_clock::time_point lastOccurrenceBound() const override;
 
     std::string type() const override { return "monthly"; }
     int getInterval() const { return repeatingInterval; }
@@ -31,4 +29,10 @@ public:
     std::chrono::system_clock::time_point getEndDate() const { return endDate; }
 
     ~MonthlyRecurrence() override = default;
+
+protected:
+    long long occurrenceSeconds(long long index) const override;
+    std::chrono::system_clock::duration occurrenceFraction() const override;
+    long long firstIndexAfter(std::chrono::system_clock::time_point t) const override;
+    long long indexLimit() const override;
 };
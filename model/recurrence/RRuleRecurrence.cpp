@@ -0,0 +1,592 @@
+#include "RRuleRecurrence.h"
+#include "../../utils/CivilDate.h"
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+// A COUNT rule is expanded up front, so keep it to a sane size
+constexpr long long kMaxCount = 1000000;
+
+std::string trim(const std::string &s)
+{
+    size_t b = s.find_first_not_of(" \t\r");
+    if (b == std::string::npos)
+        return "";
+    size_t e = s.find_last_not_of(" \t\r");
+    return s.substr(b, e - b + 1);
+}
+
+std::string upper(std::string s)
+{
+    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::toupper(c); });
+    return s;
+}
+
+std::vector<std::string> splitOn(const std::string &s, char sep)
+{
+    std::vector<std::string> parts;
+    size_t b = 0;
+    for (;;)
+    {
+        size_t e = s.find(sep, b);
+        parts.push_back(s.substr(b, e == std::string::npos ? std::string::npos : e - b));
+        if (e == std::string::npos)
+            return parts;
+        b = e + 1;
+    }
+}
+
+int parseInt(const std::string &s, const std::string &part, int lo, int hi)
+{
+    size_t i = (!s.empty() && (s[0] == '+' || s[0] == '-')) ? 1 : 0;
+    if (i == s.size() || s.size() - i > 9 ||
+        !std::all_of(s.begin() + i, s.end(), [](unsigned char c) { return std::isdigit(c); }))
+        throw std::runtime_error("Invalid RRULE " + part + " value: " + s);
+    int v = std::stoi(s);
+    if (v < lo || v > hi || v == 0)
+        throw std::runtime_error("RRULE " + part + " value out of range: " + s);
+    return v;
+}
+
+// Weekday of a two-letter code, 0 = Sunday
+int parseWeekday(const std::string &code)
+{
+    static const char *codes[] = {"SU", "MO", "TU", "WE", "TH", "FR", "SA"};
+    for (int w = 0; w < 7; ++w)
+        if (code == codes[w])
+            return w;
+    throw std::runtime_error("Invalid RRULE weekday: " + code);
+}
+
+int weekdayOf(int64_t day)
+{
+    // 1970-01-01 was a Thursday
+    return static_cast<int>(((day % 7) + 11) % 7);
+}
+
+int digits(const std::string &s, size_t pos, size_t len)
+{
+    int v = 0;
+    for (size_t i = pos; i < pos + len; ++i)
+    {
+        if (!std::isdigit(static_cast<unsigned char>(s[i])))
+            throw std::runtime_error("Invalid RRULE date: " + s);
+        v = v * 10 + (s[i] - '0');
+    }
+    return v;
+}
+
+// YYYYMMDD or YYYYMMDDTHHMMSS[Z], read as UTC. Returns seconds since the
+// epoch; a bare date gives its first second and sets `dateOnly`.
+int64_t parseDateTime(const std::string &s, bool &dateOnly)
+{
+    dateOnly = s.size() == 8;
+    if (!dateOnly && !((s.size() == 15 || (s.size() == 16 && s[15] == 'Z')) && s[8] == 'T'))
+        throw std::runtime_error("Invalid RRULE date: " + s);
+    int year = digits(s, 0, 4), month = digits(s, 4, 2), day = digits(s, 6, 2);
+    if (month < 1 || month > 12 || day < 1 || day > CivilDate::daysInMonth(year, month))
+        throw std::runtime_error("Invalid RRULE date: " + s);
+    int64_t seconds = CivilDate::daysFromCivil(year, month, day) * CivilDate::kSecondsPerDay;
+    if (!dateOnly)
+    {
+        int h = digits(s, 9, 2), m = digits(s, 11, 2), sec = digits(s, 13, 2);
+        if (h > 23 || m > 59 || sec > 60)
+            throw std::runtime_error("Invalid RRULE date: " + s);
+        seconds += h * 3600 + m * 60 + sec;
+    }
+    return seconds;
+}
+
+} // namespace
+
+class RRuleRecurrence::Cursor : public OccurrenceCursor
+{
+public:
+    Cursor(const RRuleRecurrence &rule, int64_t firstSeconds) : rule_(rule), first_(firstSeconds)
+    {
+        if (rule_.counted_)
+            pos_ = std::lower_bound(rule_.countedSeconds_.begin(), rule_.countedSeconds_.end(), first_) -
+                   rule_.countedSeconds_.begin();
+        else if (rule_.never_)
+            done_ = true;
+        else
+            period_ = rule_.periodOf(CivilDate::floorDiv(std::max(first_, rule_.startSeconds_),
+                                                         CivilDate::kSecondsPerDay));
+    }
+
+    bool next(std::chrono::system_clock::time_point &out) override
+    {
+        if (rule_.counted_)
+        {
+            if (pos_ >= rule_.countedSeconds_.size())
+                return false;
+            out = CivilDate::join(rule_.countedSeconds_[pos_++], std::chrono::system_clock::duration::zero());
+            return true;
+        }
+        while (!done_)
+        {
+            if (pos_ == days_.size())
+            {
+                int64_t firstDay = rule_.periodDays(period_++, days_);
+                pos_ = 0;
+                if (firstDay > CivilDate::floorDiv(rule_.untilSeconds_, CivilDate::kSecondsPerDay) ||
+                    !CivilDate::representable(firstDay * CivilDate::kSecondsPerDay))
+                    done_ = true;
+                continue;
+            }
+            int64_t seconds = days_[pos_++] * CivilDate::kSecondsPerDay + rule_.timeOfDay_;
+            if (seconds < first_ || seconds < rule_.startSeconds_)
+                continue;
+            if (seconds > rule_.untilSeconds_ || !CivilDate::representable(seconds))
+            {
+                done_ = true;
+                break;
+            }
+            if (rule_.excluded(seconds))
+                continue;
+            out = CivilDate::join(seconds, std::chrono::system_clock::duration::zero());
+            return true;
+        }
+        return false;
+    }
+
+private:
+    const RRuleRecurrence &rule_;
+    int64_t first_;
+    long long period_ = 0;
+    std::vector<int64_t> days_;
+    size_t pos_ = 0;
+    bool done_ = false;
+};
+
+RRuleRecurrence::RRuleRecurrence(std::chrono::system_clock::time_point start,
+                                 const std::string &rule,
+                                 std::vector<std::chrono::system_clock::time_point> exdates)
+    : rule_(rule),
+      start_(start),
+      startSeconds_(CivilDate::split(start).seconds),
+      startDay_(CivilDate::floorDiv(startSeconds_, CivilDate::kSecondsPerDay)),
+      timeOfDay_(startSeconds_ - startDay_ * CivilDate::kSecondsPerDay),
+      untilSeconds_(std::numeric_limits<int64_t>::max())
+{
+    parse(rule);
+    for (const auto &t : exdates)
+        exdates_.push_back(CivilDate::split(t).seconds);
+    std::sort(exdates_.begin(), exdates_.end());
+    exdates_.erase(std::unique(exdates_.begin(), exdates_.end()), exdates_.end());
+    compile();
+}
+
+void RRuleRecurrence::parse(const std::string &rule)
+{
+    for (const auto &raw : splitOn(rule, '\n'))
+    {
+        std::string line = trim(raw);
+        if (line.empty())
+            continue;
+        size_t colon = line.find(':');
+        if (colon == std::string::npos)
+        {
+            // A bare "FREQ=...;..." with no property name
+            parseRRule(line);
+            continue;
+        }
+        std::string name = upper(line.substr(0, colon));
+        std::string value = trim(line.substr(colon + 1));
+        if (name == "RRULE")
+        {
+            parseRRule(value);
+        }
+        else if (name == "EXDATE" || name.rfind("EXDATE;", 0) == 0)
+        {
+            if (name.find("TZID=") != std::string::npos)
+                throw std::runtime_error("EXDATE with TZID is not supported; give UTC times");
+            for (const auto &item : splitOn(value, ','))
+            {
+                bool dateOnly;
+                int64_t seconds = parseDateTime(upper(trim(item)), dateOnly);
+                // A bare date excludes the occurrence on that day
+                exdates_.push_back(dateOnly ? seconds + timeOfDay_ : seconds);
+            }
+        }
+        else
+        {
+            throw std::runtime_error("Unsupported recurrence line: " + name);
+        }
+    }
+    if (!hasFreq_)
+        throw std::runtime_error("RRULE is missing FREQ");
+}
+
+void RRuleRecurrence::parseRRule(const std::string &body)
+{
+    if (hasFreq_)
+        throw std::runtime_error("Only one RRULE is supported");
+    rruleBody_ = body;
+    std::vector<std::string> seen;
+    for (const auto &item : splitOn(body, ';'))
+    {
+        size_t eq = item.find('=');
+        if (eq == std::string::npos)
+            throw std::runtime_error("Invalid RRULE part: " + item);
+        std::string key = upper(trim(item.substr(0, eq)));
+        std::string value = upper(trim(item.substr(eq + 1)));
+        if (std::find(seen.begin(), seen.end(), key) != seen.end())
+            throw std::runtime_error("Repeated RRULE part: " + key);
+        seen.push_back(key);
+
+        if (key == "FREQ")
+        {
+            if (value == "DAILY")
+                freq_ = Frequency::Daily;
+            else if (value == "WEEKLY")
+                freq_ = Frequency::Weekly;
+            else if (value == "MONTHLY")
+                freq_ = Frequency::Monthly;
+            else if (value == "YEARLY")
+                freq_ = Frequency::Yearly;
+            else
+                throw std::runtime_error("Unsupported RRULE FREQ: " + value);
+            hasFreq_ = true;
+        }
+        else if (key == "INTERVAL")
+        {
+            interval_ = parseInt(value, key, 1, 100000);
+        }
+        else if (key == "COUNT")
+        {
+            count_ = parseInt(value, key, 1, static_cast<int>(kMaxCount));
+        }
+        else if (key == "UNTIL")
+        {
+            bool dateOnly;
+            int64_t seconds = parseDateTime(value, dateOnly);
+            // A bare date keeps the whole day
+            untilSeconds_ = dateOnly ? seconds + CivilDate::kSecondsPerDay - 1 : seconds;
+        }
+        else if (key == "WKST")
+        {
+            weekStart_ = parseWeekday(value);
+        }
+        else if (key == "BYMONTH")
+        {
+            for (const auto &v : splitOn(value, ','))
+                byMonth_.push_back(parseInt(v, key, 1, 12));
+        }
+        else if (key == "BYMONTHDAY")
+        {
+            for (const auto &v : splitOn(value, ','))
+                byMonthDay_.push_back(parseInt(v, key, -31, 31));
+        }
+        else if (key == "BYDAY")
+        {
+            for (const auto &v : splitOn(value, ','))
+            {
+                if (v.size() < 2)
+                    throw std::runtime_error("Invalid RRULE BYDAY value: " + v);
+                int ordinal = v.size() == 2 ? 0 : parseInt(v.substr(0, v.size() - 2), key, -53, 53);
+                byDay_.emplace_back(ordinal, parseWeekday(v.substr(v.size() - 2)));
+            }
+        }
+        else if (key == "BYSETPOS")
+        {
+            for (const auto &v : splitOn(value, ','))
+                bySetPos_.push_back(parseInt(v, key, -366, 366));
+        }
+        else
+        {
+            throw std::runtime_error("Unsupported RRULE part: " + key);
+        }
+    }
+    if (!hasFreq_)
+        throw std::runtime_error("RRULE is missing FREQ");
+    if (count_ != -1 && untilSeconds_ != std::numeric_limits<int64_t>::max())
+        throw std::runtime_error("RRULE cannot have both COUNT and UNTIL");
+}
+
+void RRuleRecurrence::compile()
+{
+    bool ordinals = std::any_of(byDay_.begin(), byDay_.end(), [](const std::pair<int, int> &d) { return d.first != 0; });
+    if (ordinals && (freq_ == Frequency::Daily || freq_ == Frequency::Weekly))
+        throw std::runtime_error("RRULE BYDAY ordinals need FREQ=MONTHLY or FREQ=YEARLY");
+    if (!byMonthDay_.empty() && freq_ == Frequency::Weekly)
+        throw std::runtime_error("RRULE BYMONTHDAY cannot be used with FREQ=WEEKLY");
+
+    monthMask_ = 0x0FFF;
+    if (!byMonth_.empty())
+    {
+        monthMask_ = 0;
+        for (int m : byMonth_)
+            monthMask_ |= static_cast<uint16_t>(1u << (m - 1));
+    }
+    filterMonthDay_ = !byMonthDay_.empty();
+    for (int d : byMonthDay_)
+    {
+        if (d > 0)
+            monthDayMask_ |= 1u << d;
+        else
+            monthDayFromEndMask_ |= 1u << -d;
+    }
+    filterWeekday_ = !byDay_.empty();
+    for (const auto &[ordinal, weekday] : byDay_)
+    {
+        if (ordinal == 0)
+            weekdayMask_ |= static_cast<uint8_t>(1u << weekday);
+        else if (ordinal > 0)
+            nthWeekday_[weekday] |= uint64_t(1) << ordinal;
+        else
+            nthLastWeekday_[weekday] |= uint64_t(1) << -ordinal;
+    }
+
+    // Parts the rule leaves out come from the start, as RFC 5545 says
+    int64_t startYear;
+    int startMonth, startMonthDay;
+    CivilDate::civilFromDays(startDay_, startYear, startMonth, startMonthDay);
+    int startWeekday = weekdayOf(startDay_);
+    bool byDayOrMonthDay = !byDay_.empty() || !byMonthDay_.empty();
+    if (freq_ == Frequency::Weekly && byDay_.empty())
+    {
+        filterWeekday_ = true;
+        weekdayMask_ = static_cast<uint8_t>(1u << startWeekday);
+    }
+    if ((freq_ == Frequency::Monthly || freq_ == Frequency::Yearly) && !byDayOrMonthDay)
+    {
+        filterMonthDay_ = true;
+        monthDayMask_ = 1u << startMonthDay;
+        if (freq_ == Frequency::Yearly && byMonth_.empty())
+            monthMask_ = static_cast<uint16_t>(1u << (startMonth - 1));
+    }
+    // YEARLY ordinals count through the year unless BYMONTH narrows them
+    yearScope_ = freq_ == Frequency::Yearly && byMonth_.empty();
+
+    firstPeriodDay_ = freq_ == Frequency::Weekly ? startDay_ - (startWeekday - weekStart_ + 7) % 7 : startDay_;
+    firstMonth_ = startYear * 12 + (startMonth - 1);
+    firstYear_ = startYear;
+
+    // The calendar repeats every 400 years, so a rule with no candidate in
+    // that many consecutive periods never has one.
+    long long cycle = freq_ == Frequency::Daily    ? 146097
+                      : freq_ == Frequency::Weekly ? 20871
+                      : freq_ == Frequency::Monthly ? 4800
+                                                    : 400;
+    std::vector<int64_t> days;
+    never_ = true;
+    for (long long period = 0; period < cycle && never_; ++period)
+    {
+        periodDays(period, days);
+        never_ = days.empty();
+    }
+
+    if (count_ == -1 || never_)
+    {
+        counted_ = count_ != -1;
+        return;
+    }
+    long long produced = 0;
+    for (long long period = 0; produced < count_; ++period)
+    {
+        int64_t firstDay = periodDays(period, days);
+        if (!CivilDate::representable(firstDay * CivilDate::kSecondsPerDay))
+            break;
+        for (int64_t day : days)
+        {
+            int64_t seconds = day * CivilDate::kSecondsPerDay + timeOfDay_;
+            if (seconds < startSeconds_)
+                continue;
+            if (!CivilDate::representable(seconds) || produced == count_)
+                break;
+            // Excluded dates still use up the count
+            ++produced;
+            if (!excluded(seconds))
+                countedSeconds_.push_back(seconds);
+        }
+    }
+    counted_ = true;
+}
+
+bool RRuleRecurrence::dayMatches(int64_t day, int weekday, int monthDay, int monthLength, int64_t scopeFirst,
+                                 int64_t scopeLast) const
+{
+    if (filterMonthDay_ && !((monthDayMask_ >> monthDay) & 1u) &&
+        !((monthDayFromEndMask_ >> (monthLength - monthDay + 1)) & 1u))
+        return false;
+    if (!filterWeekday_ || ((weekdayMask_ >> weekday) & 1u))
+        return true;
+    int64_t nth = (day - scopeFirst) / 7 + 1;
+    int64_t nthLast = (scopeLast - day) / 7 + 1;
+    return ((nthWeekday_[weekday] >> nth) & 1u) || ((nthLastWeekday_[weekday] >> nthLast) & 1u);
+}
+
+void RRuleRecurrence::scanMonth(int64_t year, int month, int64_t scopeFirst, int64_t scopeLast,
+                                std::vector<int64_t> &days) const
+{
+    int64_t first = CivilDate::daysFromCivil(year, month, 1);
+    int length = CivilDate::daysInMonth(year, month);
+    int weekday = weekdayOf(first);
+    for (int d = 1; d <= length; ++d)
+    {
+        if (dayMatches(first + d - 1, weekday, d, length, scopeFirst, scopeLast))
+            days.push_back(first + d - 1);
+        weekday = weekday == 6 ? 0 : weekday + 1;
+    }
+}
+
+int64_t RRuleRecurrence::periodDays(long long period, std::vector<int64_t> &days) const
+{
+    days.clear();
+    int64_t first = 0;
+    switch (freq_)
+    {
+    case Frequency::Daily:
+    case Frequency::Weekly:
+    {
+        int span = freq_ == Frequency::Daily ? 1 : 7;
+        first = firstPeriodDay_ + static_cast<int64_t>(period) * interval_ * span;
+        int64_t year;
+        int month, monthDay;
+        CivilDate::civilFromDays(first, year, month, monthDay);
+        int length = CivilDate::daysInMonth(year, month);
+        int weekday = weekdayOf(first);
+        for (int i = 0; i < span; ++i)
+        {
+            if (((monthMask_ >> (month - 1)) & 1u) &&
+                dayMatches(first + i, weekday, monthDay, length, first, first + span - 1))
+                days.push_back(first + i);
+            weekday = weekday == 6 ? 0 : weekday + 1;
+            if (++monthDay > length)
+            {
+                monthDay = 1;
+                if (++month > 12)
+                {
+                    month = 1;
+                    ++year;
+                }
+                length = CivilDate::daysInMonth(year, month);
+            }
+        }
+        break;
+    }
+    case Frequency::Monthly:
+    {
+        int64_t months = firstMonth_ + static_cast<int64_t>(period) * interval_;
+        int64_t year = CivilDate::floorDiv(months, 12);
+        int month = static_cast<int>(months - year * 12) + 1;
+        first = CivilDate::daysFromCivil(year, month, 1);
+        if ((monthMask_ >> (month - 1)) & 1u)
+            scanMonth(year, month, first, first + CivilDate::daysInMonth(year, month) - 1, days);
+        break;
+    }
+    case Frequency::Yearly:
+    {
+        int64_t year = firstYear_ + static_cast<int64_t>(period) * interval_;
+        first = CivilDate::daysFromCivil(year, 1, 1);
+        int64_t last = CivilDate::daysFromCivil(year, 12, 31);
+        for (int month = 1; month <= 12; ++month)
+        {
+            if (!((monthMask_ >> (month - 1)) & 1u))
+                continue;
+            int64_t monthFirst = CivilDate::daysFromCivil(year, month, 1);
+            int64_t monthLast = monthFirst + CivilDate::daysInMonth(year, month) - 1;
+            scanMonth(year, month, yearScope_ ? first : monthFirst, yearScope_ ? last : monthLast, days);
+        }
+        break;
+    }
+    }
+
+    if (!bySetPos_.empty() && !days.empty())
+    {
+        std::vector<int64_t> picked;
+        long long size = static_cast<long long>(days.size());
+        for (int pos : bySetPos_)
+        {
+            long long index = pos > 0 ? pos - 1 : size + pos;
+            if (index >= 0 && index < size)
+                picked.push_back(days[index]);
+        }
+        std::sort(picked.begin(), picked.end());
+        picked.erase(std::unique(picked.begin(), picked.end()), picked.end());
+        days.swap(picked);
+    }
+    return first;
+}
+
+long long RRuleRecurrence::periodOf(int64_t day) const
+{
+    long long period = 0;
+    switch (freq_)
+    {
+    case Frequency::Daily:
+        period = CivilDate::floorDiv(day - firstPeriodDay_, interval_);
+        break;
+    case Frequency::Weekly:
+        period = CivilDate::floorDiv(CivilDate::floorDiv(day - firstPeriodDay_, 7), interval_);
+        break;
+    case Frequency::Monthly:
+    case Frequency::Yearly:
+    {
+        int64_t year;
+        int month, monthDay;
+        CivilDate::civilFromDays(day, year, month, monthDay);
+        period = freq_ == Frequency::Monthly ? CivilDate::floorDiv(year * 12 + month - 1 - firstMonth_, interval_)
+                                              : CivilDate::floorDiv(year - firstYear_, interval_);
+        break;
+    }
+    }
+    return std::max(0LL, period);
+}
+
+bool RRuleRecurrence::excluded(int64_t seconds) const
+{
+    return std::binary_search(exdates_.begin(), exdates_.end(), seconds);
+}
+
+std::vector<std::chrono::system_clock::time_point> RRuleRecurrence::getExdates() const
+{
+    std::vector<std::chrono::system_clock::time_point> result;
+    for (int64_t seconds : exdates_)
+        result.push_back(CivilDate::join(seconds, std::chrono::system_clock::duration::zero()));
+    return result;
+}
+
+std::unique_ptr<OccurrenceCursor> RRuleRecurrence::occurrencesFrom(std::chrono::system_clock::time_point from) const
+{
+    auto t = CivilDate::split(from);
+    return std::make_unique<Cursor>(*this, t.frac > std::chrono::system_clock::duration::zero() ? t.seconds + 1
+                                                                                              : t.seconds);
+}
+
+std::vector<std::chrono::system_clock::time_point>
+RRuleRecurrence::getNextNOccurrences(std::chrono::system_clock::time_point after, int n) const
+{
+    std::vector<std::chrono::system_clock::time_point> result;
+    if (n <= 0)
+        return result;
+    Cursor cursor(*this, CivilDate::split(after).seconds + 1);
+    std::chrono::system_clock::time_point t;
+    while (static_cast<int>(result.size()) < n && cursor.next(t))
+        result.push_back(t);
+    return result;
+}
+
+bool RRuleRecurrence::isDueOn(std::chrono::system_clock::time_point date) const
+{
+    auto prev = date - std::chrono::seconds(1);
+    auto next = getNextNOccurrences(prev, 1);
+    return !next.empty() && next.front() == date;
+}
+
+std::chrono::system_clock::time_point RRuleRecurrence::lastOccurrenceBound() const
+{
+    if (never_)
+        return start_;
+    if (counted_)
+        return countedSeconds_.empty()
+                   ? start_
+                   : CivilDate::join(countedSeconds_.back(), std::chrono::system_clock::duration::zero());
+    if (untilSeconds_ != std::numeric_limits<int64_t>::max() && CivilDate::representable(untilSeconds_))
+        return CivilDate::join(untilSeconds_, std::chrono::system_clock::duration::zero());
+    return std::chrono::system_clock::time_point::max();
+}
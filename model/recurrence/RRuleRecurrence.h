@@ -0,0 +1,106 @@
+#pragma once
+#include "RecurrencePattern.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Repeats by an RFC 5545 RRULE such as
+// "FREQ=MONTHLY;BYDAY=MO,TU,WE,TH,FR;BYSETPOS=-1" (last weekday of the month).
+// Supports FREQ DAILY/WEEKLY/MONTHLY/YEARLY with INTERVAL, COUNT, UNTIL,
+// BYMONTH, BYMONTHDAY, BYDAY (with ordinals), BYSETPOS and WKST, plus
+// "EXDATE:" lines. Occurrences take the time of day of the event's start,
+// in UTC.
+//
+// The rule is parsed once into bitmasks over months, month days and
+// weekday ordinals; expansion then walks whole periods (a day, week, month
+// or year) in days since the epoch and tests each day against the masks.
+// Rules with a COUNT are expanded in full when constructed.
+class RRuleRecurrence : public RecurrencePattern
+{
+public:
+    // Throws std::runtime_error when the rule is malformed or uses a part
+    // this engine does not support.
+    RRuleRecurrence(std::chrono::system_clock::time_point start,
+                    const std::string &rule,
+                    std::vector<std::chrono::system_clock::time_point> exdates = {});
+
+    std::vector<std::chrono::system_clock::time_point> getNextNOccurrences(
+        std::chrono::system_clock::time_point after, int n) const override;
+    bool isDueOn(std::chrono::system_clock::time_point date) const override;
+    std::chrono::system_clock::time_point lastOccurrenceBound() const override;
+    std::unique_ptr<OccurrenceCursor> occurrencesFrom(std::chrono::system_clock::time_point from) const override;
+
+    std::string type() const override { return "rrule"; }
+    // The rule as given, including any EXDATE lines
+    const std::string &getRule() const { return rule_; }
+    // "RRULE:..." line for calendar export
+    std::string rruleLine() const { return "RRULE:" + rruleBody_; }
+    std::vector<std::chrono::system_clock::time_point> getExdates() const;
+
+    ~RRuleRecurrence() override = default;
+
+private:
+    enum class Frequency
+    {
+        Daily,
+        Weekly,
+        Monthly,
+        Yearly
+    };
+
+    class Cursor;
+
+    void parse(const std::string &rule);
+    void parseRRule(const std::string &body);
+    void compile();
+    // Candidate days of period `period`, after BYSETPOS, in order. Returns
+    // the first day the period covers.
+    int64_t periodDays(long long period, std::vector<int64_t> &days) const;
+    void scanMonth(int64_t year, int month, int64_t scopeFirst, int64_t scopeLast, std::vector<int64_t> &days) const;
+    bool dayMatches(int64_t day, int weekday, int monthDay, int monthLength, int64_t scopeFirst,
+                    int64_t scopeLast) const;
+    // Period holding day `day`, never before the first
+    long long periodOf(int64_t day) const;
+    bool excluded(int64_t seconds) const;
+
+    std::string rule_;
+    std::string rruleBody_;
+    std::chrono::system_clock::time_point start_;
+    int64_t startSeconds_;
+    int64_t startDay_;
+    int64_t timeOfDay_;
+
+    // Rule parts as parsed
+    Frequency freq_ = Frequency::Daily;
+    bool hasFreq_ = false;
+    int interval_ = 1;
+    long long count_ = -1;
+    int64_t untilSeconds_;
+    int weekStart_ = 1; // Monday
+    std::vector<int> byMonth_;
+    std::vector<int> byMonthDay_;
+    std::vector<std::pair<int, int>> byDay_; // (ordinal or 0, weekday)
+    std::vector<int> bySetPos_;
+    std::vector<int64_t> exdates_; // sorted seconds
+
+    // Compiled plan
+    uint16_t monthMask_ = 0;           // bit m-1: month m allowed
+    bool filterMonthDay_ = false;
+    uint32_t monthDayMask_ = 0;        // bit d: day d of the month
+    uint32_t monthDayFromEndMask_ = 0; // bit n: nth day from the month's end
+    bool filterWeekday_ = false;
+    uint8_t weekdayMask_ = 0;          // bit w: every weekday w (0 = Sunday)
+    uint64_t nthWeekday_[7] = {};      // bit n: nth weekday w of the scope
+    uint64_t nthLastWeekday_[7] = {};  // bit n: nth last weekday w of the scope
+    bool yearScope_ = false;           // ordinals count through the year, not the month
+    int64_t firstPeriodDay_ = 0;       // first day of period 0
+    int64_t firstMonth_ = 0;           // year * 12 + month - 1 of period 0
+    int64_t firstYear_ = 0;            // year of period 0
+    bool never_ = false;               // no period ever has a candidate
+
+    // Occurrence seconds of a COUNT rule, exdates removed
+    bool counted_ = false;
+    std::vector<int64_t> countedSeconds_;
+};
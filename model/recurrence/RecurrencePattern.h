@@ -1,9 +1,72 @@
 #pragma once
+#include <algorithm>
 #include <vector>
 #include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <memory>
 #include <string>
 using namespace std;
 
+// Forward walk over a pattern's occurrence start times, produced one at a
+// time. The pattern must outlive its cursors.
+class OccurrenceCursor
+{
+public:
+    virtual ~OccurrenceCursor() = default;
+    // Next occurrence in start order; false once the series is exhausted
+    virtual bool next(chrono::system_clock::time_point &out) = 0;
+};
+
+// Occurrences starting in [start, end), for a single pass with range-for.
+// Nothing is generated ahead of the loop, and the walk stops at the first
+// occurrence at or past `end`.
+class OccurrenceRange
+{
+public:
+    class iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = chrono::system_clock::time_point;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type *;
+        using reference = const value_type &;
+
+        iterator() = default;
+        explicit iterator(OccurrenceRange *range) : range_(range) { advance(); }
+
+        reference operator*() const { return current_; }
+        iterator &operator++()
+        {
+            advance();
+            return *this;
+        }
+        bool operator==(const iterator &other) const { return range_ == other.range_; }
+        bool operator!=(const iterator &other) const { return range_ != other.range_; }
+
+    private:
+        void advance()
+        {
+            if (!range_->cursor_ || !range_->cursor_->next(current_) || current_ >= range_->end_)
+                range_ = nullptr;
+        }
+
+        OccurrenceRange *range_ = nullptr;
+        value_type current_{};
+    };
+
+    OccurrenceRange(std::unique_ptr<OccurrenceCursor> cursor, chrono::system_clock::time_point end)
+        : cursor_(std::move(cursor)), end_(end) {}
+
+    iterator begin() { return iterator(this); }
+    iterator end() { return iterator(); }
+
+private:
+    std::unique_ptr<OccurrenceCursor> cursor_;
+    chrono::system_clock::time_point end_;
+};
+
 // Base interface for all recurrence patterns used by `RecurringEvent`.
 // Implementations provide scheduling logic for daily, weekly, monthly or
 // yearly repetition rules.
@@ -14,5 +77,67 @@ public:
                                                                          int n) const = 0;
     virtual bool isDueOn(chrono::system_clock::time_point date) const = 0;
     virtual std::string type() const = 0;
+    // Latest time any occurrence can start. Unbounded patterns return
+    // time_point::max(); the conflict index uses this to size a series.
+    virtual chrono::system_clock::time_point lastOccurrenceBound() const
+    {
+        return chrono::system_clock::time_point::max();
+    }
+
+    // Occurrences at or after `from`, generated on demand. The default pages
+    // through getNextNOccurrences; patterns that can compute an occurrence
+    // directly override it.
+    virtual std::unique_ptr<OccurrenceCursor> occurrencesFrom(chrono::system_clock::time_point from) const
+    {
+        return std::make_unique<PagedCursor>(*this, from);
+    }
+
+    OccurrenceRange occurrencesBetween(chrono::system_clock::time_point start,
+                                       chrono::system_clock::time_point end) const
+    {
+        return OccurrenceRange(occurrencesFrom(start), end);
+    }
+
     virtual ~RecurrencePattern() = default;
-};
\ No newline at end of file
+
+private:
+    class PagedCursor : public OccurrenceCursor
+    {
+    public:
+        PagedCursor(const RecurrencePattern &pattern, chrono::system_clock::time_point from)
+            : pattern_(pattern),
+              after_(from == chrono::system_clock::time_point::min() ? from : from - chrono::system_clock::duration(1))
+        {
+        }
+
+        bool next(chrono::system_clock::time_point &out) override
+        {
+            while (pos_ == page_.size())
+            {
+                if (exhausted_)
+                    return false;
+                page_ = pattern_.getNextNOccurrences(after_, pageSize_);
+                pos_ = 0;
+                exhausted_ = static_cast<int>(page_.size()) < pageSize_;
+                // Skip anything not past the last occurrence handed out, so a
+                // pattern that ignores `after` cannot make the walk repeat
+                while (pos_ < page_.size() && page_[pos_] <= after_)
+                    ++pos_;
+                if (pos_ == page_.size())
+                    exhausted_ = true;
+                pageSize_ = std::min(pageSize_ * 2, 1024);
+            }
+            out = page_[pos_++];
+            after_ = out;
+            return true;
+        }
+
+    private:
+        const RecurrencePattern &pattern_;
+        chrono::system_clock::time_point after_;
+        vector<chrono::system_clock::time_point> page_;
+        size_t pos_ = 0;
+        int pageSize_ = 16;
+        bool exhausted_ = false;
+    };
+};
@@ -1,6 +1,8 @@
 #include "WeeklyRecurrence.h"
 #include "../../utils/WeekDay.h"
+#include "../../utils/CivilDate.h"
 #include <algorithm>
+#include <limits>
 
 namespace
 {
@@ -30,64 +32,49 @@ WeeklyRecurrence::WeeklyRecurrence(
       endDate(endDate)
 {
     std::sort(this->daysOfTheWeek.begin(), this->daysOfTheWeek.end());
+    startWeekday = weekdayFromTimePoint(startingPoint);
+    skippedInFirstWeek = std::count_if(this->daysOfTheWeek.begin(), this->daysOfTheWeek.end(),
+                                       [this](Weekday w) { return w < startWeekday; });
 }
 
-vector<chrono::system_clock::time_point> WeeklyRecurrence::getNextNOccurrences(
-    chrono::system_clock::time_point after, int n) const
+long long WeeklyRecurrence::occurrenceSeconds(long long index) const
 {
-    vector<chrono::system_clock::time_point> result;
-    if (n <= 0)
-        return result;
-
-    auto day = chrono::hours(24);
-
-    // base date at midnight
-    auto daysSinceEpoch = chrono::duration_cast<chrono::hours>(startingPoint.time_since_epoch()).count() / 24;
-    auto startDayPoint = chrono::system_clock::time_point{chrono::hours(daysSinceEpoch * 24)};
-    auto timeOfDay = startingPoint - startDayPoint;
-    Weekday startWeekday = weekdayFromTimePoint(startingPoint);
-
-    long long weekIndex = 0;
-    if (after > startingPoint)
-    {
-        auto diff = after - startDayPoint;
-        auto diffWeeks = chrono::duration_cast<chrono::hours>(diff).count() / (24 * 7);
-        weekIndex = diffWeeks / repeatingInterval;
-    }
-
-    long long occurrencesChecked = weekIndex * static_cast<long long>(daysOfTheWeek.size());
-    int generated = 0;
-
-    while (generated < n)
-    {
-        for (Weekday w : daysOfTheWeek)
-        {
-            long long offsetDays = weekIndex * repeatingInterval * 7 + (static_cast<int>(w) - static_cast<int>(startWeekday));
-            auto candidate = startDayPoint + chrono::hours(24 * offsetDays) + timeOfDay;
-
-            if (candidate < startingPoint)
-                continue;
-
-            if (candidate > endDate)
-                return result;
-
-            if (maxOccurrences != -1 && occurrencesChecked >= maxOccurrences)
-                return result;
+    long long perWeek = static_cast<long long>(daysOfTheWeek.size());
+    long long slot = index + skippedInFirstWeek;
+    long long week = slot / perWeek;
+    long long offsetDays = week * std::max(1, repeatingInterval) * 7 +
+                           (static_cast<int>(daysOfTheWeek[slot % perWeek]) - static_cast<int>(startWeekday));
+    return CivilDate::split(startingPoint).seconds + offsetDays * CivilDate::kSecondsPerDay;
+}
 
-            if (candidate > after)
-            {
-                result.push_back(candidate);
-                ++generated;
-                if (generated >= n)
-                    return result;
-            }
+long long WeeklyRecurrence::firstIndexAfter(chrono::system_clock::time_point t) const
+{
+    if (daysOfTheWeek.empty())
+        return 0;
+    auto start = CivilDate::split(startingPoint);
+    auto target = CivilDate::split(t);
+    // Every listed day of the weeks before `week` is at least a day before t,
+    // so the answer is within this week or the next.
+    long long daysIn = CivilDate::floorDiv(target.seconds - start.seconds, CivilDate::kSecondsPerDay);
+    long long week = std::max<long long>(0, CivilDate::floorDiv(daysIn, std::max(1, repeatingInterval) * 7LL));
+    long long index = week == 0 ? 0 : week * static_cast<long long>(daysOfTheWeek.size()) - skippedInFirstWeek;
+    while (!CivilDate::later(occurrenceSeconds(index), start.frac, target))
+        ++index;
+    return index;
+}
 
-            ++occurrencesChecked;
-        }
-        ++weekIndex;
-    }
+long long WeeklyRecurrence::indexLimit() const
+{
+    if (daysOfTheWeek.empty())
+        return 0;
+    long long limit = maxOccurrences == -1 ? std::numeric_limits<long long>::max()
+                                           : std::max(0, maxOccurrences);
+    return std::min(limit, firstIndexAfter(endDate));
+}
 
-    return result;
+chrono::system_clock::duration WeeklyRecurrence::occurrenceFraction() const
+{
+    return CivilDate::split(startingPoint).frac;
 }
 
 bool WeeklyRecurrence::isDueOn(chrono::system_clock::time_point date) const
@@ -95,4 +82,17 @@ bool WeeklyRecurrence::isDueOn(chrono::system_clock::time_point date) const
     auto prevMoment = date - chrono::seconds(1);
     auto next = getNextNOccurrences(prevMoment, 1);
     return !next.empty() && next.front() == date;
-}
\ No newline at end of file
+}
+
+chrono::system_clock::time_point WeeklyRecurrence::lastOccurrenceBound() const
+{
+    if (maxOccurrences == -1)
+        return endDate;
+    long long limit = indexLimit();
+    if (limit <= 0)
+        return startingPoint;
+    chrono::system_clock::time_point last;
+    if (!occurrenceAt(limit - 1, last))
+        return chrono::system_clock::time_point::max();
+    return last;
+}
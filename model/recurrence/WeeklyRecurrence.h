@@ -1,4 +1,4 @@
-#include "RecurrencePattern.h"
+#include "IndexedRecurrence.h"
 #include <vector>
 #include <chrono>
 #include <algorithm>
@@ -9,7 +9,7 @@
 // with a weekly interval.
 // For example, every week on Tuesday and Thursday I have Object Oriented Design class.
 // For example, every 2 weeks I go to Church on Sunday.
-class WeeklyRecurrence : public RecurrencePattern
+class WeeklyRecurrence : public IndexedRecurrence
 {
 private:
     // First date/time of the recurrence (UTC)
@@ -18,6 +18,8 @@ private:
     int repeatingInterval;                          // This is the x in every x weeks.
     int maxOccurrences;                             // optional: stop after N times (-1 = unlimited)
     chrono::system_clock::time_point endDate;       // optional: stop by a certain date
+    Weekday startWeekday;                           // local weekday of startingPoint
+    long long skippedInFirstWeek;                   // listed days that fall before startingPoint
 public:
     WeeklyRecurrence(chrono::system_clock::time_point start,
                      vector<Weekday> daysOfTheWeek,
@@ -25,10 +27,8 @@ public:
                      int maxOccurrences = -1,
                      chrono::system_clock::time_point endDate = chrono::system_clock::time_point::max());
 
-    std::vector<chrono::system_clock::time_point> getNextNOccurrences(
-        chrono::system_clock::time_point after, int n) const override;
-
     bool isDueOn(chrono::system_clock::time_point date) const override;
+    chrono::system_clock::time_point lastOccurrenceBound() const override;
 
     std::string type() const override { return "weekly"; }
     int getInterval() const { return repeatingInterval; }
@@ -37,4 +37,12 @@ public:
     chrono::system_clock::time_point getEndDate() const { return endDate; }
 
     ~WeeklyRecurrence() override = default;
+
+protected:
+    // Occurrence `index` counts listed days from startingPoint on, so
+    // index + skippedInFirstWeek splits into a week and a slot in it.
+    long long occurrenceSeconds(long long index) const override;
+    chrono::system_clock::duration occurrenceFraction() const override;
+    long long firstIndexAfter(chrono::system_clock::time_point t) const override;
+    long long indexLimit() const override;
 };
@@ -196,12 +196,17 @@ void WakeScheduler::scheduleToday() {
 
 void WakeScheduler::scheduleDailyMaintenance() {
     // Compute next local midnight and schedule a task to reschedule today's wake
+    // and purge soft-deleted events past their retention
     auto now = system_clock::now();
     auto nextMid = nextLocalMidnight(now);
     auto task = std::make_shared<ScheduledTask>(
         "wake:maintenance", "wake maintenance", "Wake Maintenance",
         nextMid, seconds(0), std::vector<system_clock::time_point>{}, []{},
-        [this]() { const_cast<WakeScheduler*>(this)->scheduleToday(); const_cast<WakeScheduler*>(this)->scheduleDailyMaintenance(); }
+        [this]() {
+            model_.compactTombstones();
+            const_cast<WakeScheduler*>(this)->scheduleToday();
+            const_cast<WakeScheduler*>(this)->scheduleDailyMaintenance();
+        }
     );
     task->setCategory("internal");
     loop_.addTask(task);
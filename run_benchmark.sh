@@ -19,6 +19,30 @@ case "${1:-all}" in
         echo "Running model benchmarks..."
         ./benchmark --model
         ;;
+    "index")
+        echo "Running ID index scaling benchmarks..."
+        ./benchmark --index
+        ;;
+    "contention")
+        echo "Running read/write contention benchmarks..."
+        ./benchmark --contention
+        ;;
+    "persistence")
+        echo "Running SQLite persistence benchmarks..."
+        ./benchmark --persistence
+        ;;
+    "recurrence")
+        echo "Running recurrence expansion benchmarks..."
+        ./benchmark --recurrence
+        ;;
+    "layout")
+        echo "Running event layout benchmarks..."
+        ./benchmark --layout
+        ;;
+    "search")
+        echo "Running search benchmarks..."
+        ./benchmark --search
+        ;;
     "api") 
         echo "Running API benchmarks..."
         ./benchmark --api
@@ -32,10 +56,16 @@ case "${1:-all}" in
         ./benchmark
         ;;
     "help"|"-h"|"--help")
-        echo "Usage: $0 [model|api|full|all]"
+        echo "Usage: $0 [model|index|contention|persistence|recurrence|layout|search|api|full|all]"
         echo ""
         echo "Options:"
         echo "  model    - Test event creation and retrieval performance"
+        echo "  index    - Test ID lookup/update/delete cost from 1k to 1M events"
+        echo "  contention - Read latency percentiles during a write storm"
+        echo "  persistence - Synchronous vs write-behind SQLite write throughput"
+        echo "  recurrence - Ten years of RRULE expansion vs the built-in patterns"
+        echo "  layout   - Full-scan cost and bytes per event in the in-memory store"
+        echo "  search   - Bounded edit distance vs full DP, and searchEvents latency"
         echo "  api      - Test HTTP API performance and caching" 
         echo "  full     - Complete system load test"
         echo "  all      - Run all benchmark suites (default)"
@@ -2,16 +2,20 @@
 #include <cstdio>
 #include <memory>
 #include "../../database/SQLiteScheduleDatabase.h"
+#include "../../database/WriteBehindScheduleDatabase.h"
 #include "../../model/Model.h"
+#include "../../calendar/CalendarApi.h"
 #include "../../model/RecurringEvent.h"
 #include "../../model/OneTimeEvent.h"
 #include "../../model/recurrence/DailyRecurrence.h"
 #include "../../model/recurrence/WeeklyRecurrence.h"
 #include "../../model/recurrence/MonthlyRecurrence.h"
 #include "../../model/recurrence/YearlyRecurrence.h"
+#include "../../model/recurrence/RRuleRecurrence.h"
 #include "../test_utils.h"
 #include <iostream>
 #include <sqlite3.h>
+#include <string>
 
 using namespace std;
 using namespace chrono;
@@ -200,6 +204,36 @@ static void testYearlyPersistence()
     std::remove(path);
 }
 
+static void testRRulePersistence()
+{
+    const char *path = "test_persist.db";
+    std::remove(path);
+    auto start = makeTime(2025, 1, 1, 9);
+    std::string rule = "RRULE:FREQ=MONTHLY;BYDAY=MO,TU,WE,TH,FR;BYSETPOS=-1\nEXDATE:20250228T090000Z";
+    {
+        SQLiteScheduleDatabase db(path);
+        auto pat = std::make_shared<RRuleRecurrence>(start, rule,
+                                                     std::vector<std::chrono::system_clock::time_point>{
+                                                         makeTime(2025, 3, 31, 9)});
+        RecurringEvent r("RR", "desc", "title", start, hours(1), pat);
+        assert(db.addEvent(r));
+    }
+    {
+        SQLiteScheduleDatabase db(path);
+        auto loaded = db.getEventById("RR");
+        auto *re = dynamic_cast<RecurringEvent *>(loaded.get());
+        assert(re);
+        auto *rr = dynamic_cast<RRuleRecurrence *>(re->getRecurrencePattern().get());
+        assert(rr && rr->getRule() == rule);
+        auto next = rr->getNextNOccurrences(start - seconds(1), 3);
+        assert(next.size() == 3);
+        assert(next[0] == makeTime(2025, 1, 31, 9));
+        assert(next[1] == makeTime(2025, 4, 30, 9));
+        assert(next[2] == makeTime(2025, 5, 30, 9));
+    }
+    std::remove(path);
+}
+
 static void testRemoveAllDatabase()
 {
     const char *path = "test_persist.db";
@@ -243,6 +277,555 @@ static void testRemoveBeforeDatabase()
     std::remove(path);
 }
 
+static void testWriteBehindBatchesAndFlushes()
+{
+    const char *path = "test_write_behind.db";
+    std::remove(path);
+    {
+        auto sqlite = std::make_shared<SQLiteScheduleDatabase>(path);
+        // Long interval so only size and flush() trigger commits
+        WriteBehindScheduleDatabase journal(sqlite, seconds(60), 100);
+        Model m(&journal);
+        for (int i = 0; i < 250; i++)
+        {
+            OneTimeEvent e(to_string(i), "d", "t", makeTime(2025, 6, 1, 8) + minutes(i), minutes(30));
+            m.addEvent(e);
+        }
+        assert(m.removeEvent("0"));
+        m.flush();
+        assert(journal.pendingWrites() == 0);
+        assert(sqlite->getAllEvents().size() == 249);
+        // 251 writes went out in a handful of transactions, not one per row
+        assert(journal.committedBatches() <= 4);
+
+        // Writes still queued at destruction are drained, not lost
+        m.removeAllEvents();
+        OneTimeEvent last("last", "d", "t", makeTime(2025, 6, 2, 8), minutes(30));
+        m.addEvent(last);
+    }
+    {
+        SQLiteScheduleDatabase db(path);
+        auto events = db.getAllEvents();
+        assert(events.size() == 1 && events[0]->getId() == "last");
+    }
+    std::remove(path);
+}
+
+// SQLite store whose next `failCommits` commits fail
+class FlakyCommitDatabase : public SQLiteScheduleDatabase
+{
+public:
+    using SQLiteScheduleDatabase::SQLiteScheduleDatabase;
+    int failCommits = 0;
+
+    bool commitTransaction() override
+    {
+        if (failCommits > 0)
+        {
+            --failCommits;
+            return false;
+        }
+        return SQLiteScheduleDatabase::commitTransaction();
+    }
+};
+
+static void testWriteBehindCommitFailures()
+{
+    const char *path = "test_write_behind.db";
+    std::remove(path);
+    {
+        auto sqlite = std::make_shared<FlakyCommitDatabase>(path);
+        WriteBehindScheduleDatabase journal(sqlite, milliseconds(5), 100);
+
+        // One failed commit is retried and the write lands
+        sqlite->failCommits = 1;
+        journal.addEvent(OneTimeEvent("kept", "d", "t", makeTime(2025, 6, 1, 8), minutes(30)));
+        assert(journal.flush());
+        assert(sqlite->getEventById("kept"));
+
+        // A batch that never commits is reported, not passed off as durable
+        sqlite->failCommits = 1000;
+        journal.addEvent(OneTimeEvent("lost", "d", "t", makeTime(2025, 6, 1, 9), minutes(30)));
+        assert(!journal.flush());
+        assert(journal.lostWrites() == 1);
+        assert(!sqlite->getEventById("lost"));
+
+        // The error sticks even once commits work again
+        sqlite->failCommits = 0;
+        journal.addEvent(OneTimeEvent("later", "d", "t", makeTime(2025, 6, 1, 10), minutes(30)));
+        assert(!journal.flush());
+        assert(sqlite->getEventById("later"));
+    }
+    std::remove(path);
+}
+
+static void testWriteBehindTransactions()
+{
+    const char *path = "test_write_behind_tx.db";
+    std::remove(path);
+    auto t = makeTime(2025, 6, 2, 9);
+    {
+        // One write per batch, so only the transaction keeps a move's two writes together
+        auto sqlite = std::make_shared<FlakyCommitDatabase>(path);
+        WriteBehindScheduleDatabase journal(sqlite, milliseconds(5), 1);
+        Model m(&journal);
+        m.addEvent(OneTimeEvent("a", "d", "a", t, hours(1)));
+        m.addEvent(OneTimeEvent("b", "d", "b", t + hours(2), hours(1)));
+        assert(journal.flush());
+
+        // Enough failures to exhaust one batch's retries: a soft delete loses
+        // both of its writes, not just the first
+        sqlite->failCommits = 3;
+        assert(m.removeEvent("a", true));
+        assert(!journal.flush());
+        assert(journal.lostWrites() == 2);
+        assert(sqlite->getEventById("a") && !sqlite->getTombstone("a"));
+
+        // Likewise a restore
+        assert(m.removeEvent("b", true));
+        journal.flush();
+        assert(!sqlite->getEventById("b") && sqlite->getTombstone("b"));
+        sqlite->failCommits = 3;
+        assert(m.restoreEvent("b"));
+        journal.flush();
+        assert(journal.lostWrites() == 4);
+        assert(!sqlite->getEventById("b") && sqlite->getTombstone("b"));
+
+        // A rolled back transaction queues nothing, and one thread gets one
+        // transaction at a time
+        assert(journal.beginTransaction());
+        journal.addEvent(OneTimeEvent("c", "d", "c", t, hours(1)));
+        assert(!journal.beginTransaction());
+        assert(journal.pendingWrites() == 0);
+        assert(journal.rollbackTransaction());
+        journal.flush();
+        assert(!sqlite->getEventById("c") && journal.lostWrites() == 4);
+    }
+    std::remove(path);
+}
+
+static void testPagedLoading()
+{
+    const char *path = "test_paged.db";
+    std::remove(path);
+    auto now = time_point_cast<seconds>(system_clock::now());
+    auto day = hours(24);
+    {
+        SQLiteScheduleDatabase db(path);
+        Model m(&db);
+        m.addEvent(OneTimeEvent("old", "d", "Archive review", now - 60 * day, hours(1)));
+        m.addEvent(OneTimeEvent("near", "d", "Dentist", now + 2 * day, hours(1)));
+        m.addEvent(OneTimeEvent("far", "d", "Offsite", now + 90 * day, hours(1)));
+        m.addEvent(OneTimeEvent("long", "d", "Sabbatical", now + 80 * day, 20 * day));
+        auto rec = std::make_shared<DailyRecurrence>(now - 100 * day, 1);
+        m.addEvent(RecurringEvent("R", "d", "Standup", now - 100 * day, minutes(15), rec));
+    }
+    {
+        SQLiteScheduleDatabase db(path);
+        Model m(&db, 7);
+        // Only the window and the series are resident at startup
+        assert(m.snapshot()->size() == 2);
+
+        // Range queries load what they reach
+        auto range = m.getEventsInRange(now + 89 * day, now + 91 * day);
+        assert(range.size() == 1 && range[0].getId() == "far");
+        // Overlap queries look back by the longest stored event
+        bool sawLong = false;
+        for (const auto &c : m.getConflicts(now + 95 * day, minutes(30)))
+            sawLong = sawLong || c.getId() == "long";
+        assert(sawLong);
+        assert(m.snapshot()->size() == 4);
+
+        // By-ID operations find rows outside the window
+        assert(m.getEventById("old") && m.snapshot()->size() == 5);
+        assert(m.removeEvent("old"));
+        assert(!db.getEventById("old"));
+
+        // Nothing loaded twice, and soft-deleted rows are not brought back
+        assert(m.removeEvent("far", true));
+        assert(m.getEventsInRange(now + 60 * day, now + 120 * day).size() == 1);
+        assert(m.searchEvents("offsite").empty() && m.searchEvents("sabbatical").size() == 1);
+        assert(m.restoreEvent("far") && m.searchEvents("offsite").size() == 1);
+    }
+    std::remove(path);
+}
+
+static void testTombstones()
+{
+    const char *path = "test_tombstones.db";
+    std::remove(path);
+    auto t = makeTime(2025, 6, 2, 9);
+    {
+        SQLiteScheduleDatabase db(path);
+        Model m(&db);
+        for (const char *id : {"a", "b", "c", "d"})
+            m.addEvent(OneTimeEvent(id, "d", id, t, hours(1)));
+        assert(m.removeEvent("a", true) && m.removeEvent("b", true));
+        // Soft-deleted rows leave the event table for the tombstone table
+        assert(!db.getEventById("a") && db.getTombstone("a"));
+    }
+    {
+        // Tombstones survive a restart and page from disk
+        SQLiteScheduleDatabase db(path);
+        Model m(&db);
+        assert(m.snapshot()->size() == 2);
+        assert(m.getDeletedEvents().size() == 2);
+        auto page = m.getDeletedEvents(1, 1);
+        assert(page.size() == 1 && page[0].getId() == "b");
+        assert(m.restoreEvent("a") && m.getEventById("a") && db.getEventById("a"));
+        assert(!db.getTombstone("a") && !m.restoreEvent("a"));
+
+        // Past the count bound the oldest deletions go first
+        m.setTombstoneRetention(hours(24), 2);
+        assert(m.removeEvent("c", true) && m.removeEvent("d", true));
+        assert(m.getDeletedEvents().size() == 2 && !m.restoreEvent("b"));
+        assert(db.getTombstoneIds().size() == 2);
+
+        // Past the TTL they all go, in one purge
+        m.setTombstoneRetention(seconds(0), 2);
+        assert(m.getDeletedEvents().empty() && db.getTombstoneIds().empty());
+        assert(!m.restoreEvent("c"));
+    }
+    {
+        // Through the write-behind journal, reads see queued tombstone writes
+        auto db = std::make_shared<WriteBehindScheduleDatabase>(std::make_shared<SQLiteScheduleDatabase>(path));
+        Model m(db.get());
+        assert(m.removeEvent("a", true));
+        assert(m.getDeletedEvents().size() == 1 && m.restoreEvent("a"));
+        assert(db->getTombstoneIds().empty() && db->getEventById("a"));
+    }
+    std::remove(path);
+}
+
+// Counts batch calls and hands back a provider ID per added event
+class RecordingApi : public CalendarApi
+{
+public:
+    int addBatches = 0, updateBatches = 0, deleteBatches = 0, singleCalls = 0;
+    size_t deletedRows = 0;
+
+    ProviderIds addEvent(const Event &) override { ++singleCalls; return {}; }
+    ProviderIds updateEvent(const Event &, const Event &) override { ++singleCalls; return {}; }
+    void deleteEvent(const Event &) override { ++singleCalls; }
+
+    std::vector<ProviderIds> addEvents(const std::vector<const Event *> &events) override
+    {
+        ++addBatches;
+        std::vector<ProviderIds> ids;
+        for (const auto *e : events)
+            ids.push_back({"g-" + e->getId(), ""});
+        return ids;
+    }
+    std::vector<ProviderIds> updateEvents(const std::vector<std::pair<const Event *, const Event *>> &changes) override
+    {
+        ++updateBatches;
+        return std::vector<ProviderIds>(changes.size());
+    }
+    void deleteEvents(const std::vector<const Event *> &events) override
+    {
+        ++deleteBatches;
+        deletedRows += events.size();
+    }
+};
+
+// SQLite store that counts the rows range reads hand back
+class ReadCountingDatabase : public SQLiteScheduleDatabase
+{
+public:
+    using SQLiteScheduleDatabase::SQLiteScheduleDatabase;
+    mutable size_t rowsRead = 0;
+
+    std::vector<std::unique_ptr<Event>> getEventsInRange(system_clock::time_point start, system_clock::time_point end,
+                                                         size_t limit) const override
+    {
+        auto rows = SQLiteScheduleDatabase::getEventsInRange(start, end, limit);
+        rowsRead += rows.size();
+        return rows;
+    }
+};
+
+static void testPagedRangeRemoval()
+{
+    const char *path = "test_paged.db";
+    std::remove(path);
+    auto now = time_point_cast<seconds>(system_clock::now());
+    auto day = hours(24);
+    {
+        SQLiteScheduleDatabase db(path);
+        Model m(&db);
+        for (int i = 0; i < 40; i++)
+            m.addEvent(OneTimeEvent("old" + to_string(i), "d", "t", now - (100 + i) * day, hours(1)));
+        m.addEvent(OneTimeEvent("near", "d", "t", now + day, hours(1)));
+        auto rec = std::make_shared<DailyRecurrence>(now - 200 * day, 1);
+        m.addEvent(RecurringEvent("R", "d", "t", now - 200 * day, minutes(15), rec));
+    }
+    {
+        ReadCountingDatabase db(path);
+        Model m(&db, 7);
+        assert(m.snapshot()->size() == 2);
+        size_t startupReads = db.rowsRead;
+        // Retention deletes the old rows in the store without loading them:
+        // 19 old rows plus the series, which starts in range too
+        assert(m.removeEventsBefore(now - 120 * day) == 20);
+        assert(db.rowsRead == startupReads && m.snapshot()->size() == 1);
+        assert(db.countEventsInRange(system_clock::time_point::min(), now) == 21);
+        assert(!db.getEventById("R"));
+        assert(m.getEventsInRange(now - 300 * day, now - 121 * day).empty());
+
+        // With a provider attached the rows are read, so it hears of each
+        auto api = std::make_shared<RecordingApi>();
+        m.addCalendarApi(api);
+        assert(m.removeEventsBefore(now - 50 * day) == 21);
+        assert(api->deletedRows == 21 && db.rowsRead == startupReads + 21 && m.snapshot()->size() == 1);
+        assert(db.countEventsInRange(system_clock::time_point::min(), now) == 0);
+
+        // If the store refuses the delete, memory keeps the rows too
+        m.addEvent(OneTimeEvent("kept", "d", "t", now - 2 * day, hours(1)));
+        sqlite3 *conn = nullptr;
+        assert(sqlite3_open(path, &conn) == SQLITE_OK);
+        assert(sqlite3_exec(conn, "CREATE TRIGGER refuse_delete BEFORE DELETE ON events "
+                                  "BEGIN SELECT RAISE(ABORT, 'refused'); END;",
+                            nullptr, nullptr, nullptr) == SQLITE_OK);
+        sqlite3_close(conn);
+        assert(m.removeEventsBefore(now - day) == 0);
+        assert(m.getEventById("kept") && db.getEventById("kept") && api->deletedRows == 21);
+    }
+    std::remove(path);
+}
+
+static void testRenameOntoExistingId()
+{
+    const char *path = "test_rename.db";
+    std::remove(path);
+    auto now = time_point_cast<seconds>(system_clock::now());
+    {
+        SQLiteScheduleDatabase db(path);
+        Model m(&db);
+        m.addEvent(OneTimeEvent("a", "d", "first", now + hours(1), hours(1)));
+        m.addEvent(OneTimeEvent("b", "d", "second", now + hours(24 * 30), hours(1)));
+    }
+    {
+        // "b" is outside the resident window, so only the store knows it
+        SQLiteScheduleDatabase db(path);
+        Model m(&db, 7);
+        assert(!m.updateEvent("a", OneTimeEvent("b", "d", "renamed", now + hours(2), hours(1))));
+        auto a = m.getEventById("a");
+        auto b = m.getEventById("b");
+        assert(a && a->getTitle() == "first");
+        assert(b && b->getTitle() == "second");
+        assert(db.getEventById("b")->getTitle() == "second");
+        assert(m.updateEvent("a", OneTimeEvent("c", "d", "renamed", now + hours(2), hours(1))));
+        assert(!m.getEventById("a") && m.getEventById("c"));
+    }
+    std::remove(path);
+}
+
+static void testUpdatesFollowTheStore()
+{
+    const char *path = "test_update_store.db";
+    std::remove(path);
+    auto t = makeTime(2025, 6, 2, 9);
+    {
+        FlakyCommitDatabase db(path);
+        Model m(&db);
+        m.addEvent(OneTimeEvent("x", "d", "x", t, hours(1)));
+
+        // A rename the store cannot commit keeps the old row, in both places
+        db.failCommits = 1;
+        assert(!m.updateEvent("x", OneTimeEvent("y", "d", "y", t, hours(1))));
+        assert(m.getEventById("x") && db.getEventById("x"));
+        assert(!m.getEventById("y") && !db.getEventById("y"));
+        assert(m.updateEvent("x", OneTimeEvent("y", "d", "y", t, hours(1))));
+        assert(!db.getEventById("x") && db.getEventById("y"));
+
+        // Edits the store refuses are not applied in memory either
+        sqlite3 *conn = nullptr;
+        assert(sqlite3_open(path, &conn) == SQLITE_OK);
+        assert(sqlite3_exec(conn, "CREATE TRIGGER refuse_update BEFORE UPDATE ON events "
+                                  "BEGIN SELECT RAISE(ABORT, 'refused'); END;",
+                            nullptr, nullptr, nullptr) == SQLITE_OK);
+        sqlite3_close(conn);
+        assert(!m.updateEvent("y", OneTimeEvent("y", "d", "edited", t, hours(1))));
+        assert(!m.updateEventFields("y", {{"title", "edited"}}));
+        assert(m.getEventById("y")->getTitle() == "y" && db.getEventById("y")->getTitle() == "y");
+    }
+    std::remove(path);
+}
+
+static void testTombstoneMovesAreAtomic()
+{
+    const char *path = "test_tombstones.db";
+    std::remove(path);
+    auto t = makeTime(2025, 6, 2, 9);
+    {
+        auto db = std::make_shared<FlakyCommitDatabase>(path);
+        Model m(db.get());
+        m.addEvent(OneTimeEvent("a", "d", "a", t, hours(1)));
+
+        // A soft delete the store cannot commit leaves everything in place
+        db->failCommits = 1;
+        assert(!m.removeEvent("a", true));
+        assert(db->getEventById("a") && !db->getTombstone("a"));
+        assert(m.getDeletedEvents().empty() && m.getEventsInRange(t, t + hours(24)).size() == 1);
+
+        assert(m.removeEvent("a", true));
+        assert(!db->getEventById("a") && db->getTombstone("a"));
+
+        // Likewise a restore keeps the tombstone until the row is back
+        db->failCommits = 1;
+        assert(!m.restoreEvent("a"));
+        assert(!db->getEventById("a") && db->getTombstone("a"));
+        assert(m.getDeletedEvents().size() == 1 && m.getEventsInRange(t, t + hours(24)).empty());
+
+        assert(m.restoreEvent("a"));
+        assert(db->getEventById("a") && !db->getTombstone("a"));
+    }
+    std::remove(path);
+}
+
+static void testBulkOperations()
+{
+    const char *path = "test_bulk.db";
+    std::remove(path);
+    auto t = makeTime(2025, 6, 2, 9);
+    {
+        SQLiteScheduleDatabase db(path);
+        Model m(&db);
+        auto api = std::make_shared<RecordingApi>();
+        m.addCalendarApi(api);
+        m.addEvent(OneTimeEvent("x", "d", "existing", t, hours(1)));
+        api->singleCalls = 0;
+
+        std::vector<Event> batch;
+        for (int i = 0; i < 500; ++i)
+            batch.push_back(OneTimeEvent("e" + std::to_string(i), "d", "import", t + hours(i), hours(1)));
+        batch.push_back(OneTimeEvent("x", "d", "clash", t, hours(1)));
+        batch.push_back(OneTimeEvent("e0", "d", "repeat", t, hours(1)));
+        auto added = m.addEvents(batch);
+        assert(added.size() == 502 && added[0] && added[499] && !added[500] && !added[501]);
+        assert(m.getEventById("e0")->getTitle() == "import");
+        assert(m.getEventById("x")->getTitle() == "existing");
+        // One provider call for the batch, and its IDs are stored
+        assert(api->addBatches == 1 && api->singleCalls == 0);
+        assert(m.getEventById("e7")->getProviderEventId() == "g-e7");
+
+        auto updated = m.updateEvents({{"e1", OneTimeEvent("e1", "d", "moved", t, hours(2))},
+                                       {"nope", OneTimeEvent("nope", "d", "t", t, hours(1))}});
+        assert(updated.size() == 2 && updated[0] && !updated[1] && api->updateBatches == 1);
+
+        assert(m.removeEvents({"e2", "e3", "e2", "missing"}) == 2 && api->deleteBatches == 1);
+        assert(m.snapshot()->size() == 499);
+    }
+    {
+        // The batches reached the database
+        SQLiteScheduleDatabase db(path);
+        assert(db.getAllEvents().size() == 499);
+        auto e1 = db.getEventById("e1");
+        assert(e1 && e1->getTitle() == "moved" && !db.getEventById("e2"));
+        assert(db.getEventById("e9")->getProviderEventId() == "g-e9");
+    }
+    std::remove(path);
+}
+
+static void testBulkWritesAreAtomic()
+{
+    const char *path = "test_bulk_atomic.db";
+    std::remove(path);
+    auto t = makeTime(2025, 6, 2, 9);
+    {
+        FlakyCommitDatabase db(path);
+        Model m(&db);
+        m.addEvent(OneTimeEvent("x", "d", "x", t, hours(1)));
+
+        // A batch the store cannot commit is not applied at all
+        db.failCommits = 1;
+        auto added = m.addEvents({OneTimeEvent("a", "d", "a", t + hours(2), hours(1)),
+                                  OneTimeEvent("b", "d", "b", t + hours(4), hours(1))});
+        assert(!added[0] && !added[1]);
+        assert(!m.getEventById("a") && !db.getEventById("a") && m.snapshot()->size() == 1);
+        db.failCommits = 1;
+        assert(m.removeEvents({"x"}) == 0);
+        assert(m.getEventById("x") && db.getEventById("x"));
+        db.failCommits = 1;
+        auto updated = m.updateEvents({{"x", OneTimeEvent("x", "d", "changed", t, hours(1))}});
+        assert(!updated[0] && m.getEventById("x")->getTitle() == "x" && db.getEventById("x")->getTitle() == "x");
+
+        // A row that fails midway undoes the rows written before it
+        sqlite3 *conn = nullptr;
+        assert(sqlite3_open(path, &conn) == SQLITE_OK);
+        assert(sqlite3_exec(conn, "CREATE TRIGGER refuse_bad BEFORE INSERT ON events WHEN NEW.id = 'bad' "
+                                  "BEGIN SELECT RAISE(ABORT, 'refused'); END;",
+                            nullptr, nullptr, nullptr) == SQLITE_OK);
+        sqlite3_close(conn);
+        auto mixed = m.addEvents({OneTimeEvent("c", "d", "c", t + hours(2), hours(1)),
+                                  OneTimeEvent("bad", "d", "bad", t + hours(4), hours(1))});
+        assert(!mixed[0] && !mixed[1]);
+        assert(!db.getEventById("c") && !m.getEventById("c"));
+        auto fine = m.addEvents({OneTimeEvent("c", "d", "c", t + hours(2), hours(1))});
+        assert(fine[0] && db.getEventById("c") && m.getEventById("c"));
+    }
+    std::remove(path);
+}
+
+// rowid of the stored row; INSERT OR REPLACE gives the row a new one
+static long long rowidOf(const char *path, const std::string &id)
+{
+    sqlite3 *conn = nullptr;
+    assert(sqlite3_open(path, &conn) == SQLITE_OK);
+    sqlite3_stmt *st = nullptr;
+    sqlite3_prepare_v2(conn, "SELECT rowid FROM events WHERE id = ?", -1, &st, nullptr);
+    sqlite3_bind_text(st, 1, id.c_str(), -1, SQLITE_TRANSIENT);
+    long long rowid = sqlite3_step(st) == SQLITE_ROW ? sqlite3_column_int64(st, 0) : -1;
+    sqlite3_finalize(st);
+    sqlite3_close(conn);
+    return rowid;
+}
+
+static void testPartialUpdates()
+{
+    OneTimeEvent probe("p", "d", "t", makeTime(2025, 6, 2, 9), hours(1));
+    assert(probe.dirtyFields() == 0);
+    probe.setTitle("x");
+    probe.setProviderEventId("g");
+    assert(probe.dirtyFields() == (Event::kTitle | Event::kProviderEventId));
+    assert(probe.clone()->dirtyFields() == probe.dirtyFields());
+    probe.clearDirty();
+    assert(probe.dirtyFields() == 0);
+
+    const char *path = "test_partial.db";
+    std::remove(path);
+    auto t = makeTime(2025, 6, 2, 9);
+    {
+        SQLiteScheduleDatabase db(path);
+        Model m(&db);
+        auto rec = std::make_shared<WeeklyRecurrence>(t, std::vector<Weekday>{Weekday::Monday}, 1);
+        m.addEvent(RecurringEvent("R", "d", "Standup", t, minutes(15), rec, "work"));
+        m.addEvent(OneTimeEvent("A", "d", "Dentist", t, hours(1)));
+        long long r = rowidOf(path, "R"), a = rowidOf(path, "A");
+
+        // Field edits update the row in place and leave other columns alone
+        assert(m.updateEventFields("R", {{"provider_event_id", "g-R"}}));
+        assert(m.updateEventFields("A", {{"title", "Dentist (moved)"}}));
+        assert(rowidOf(path, "R") == r && rowidOf(path, "A") == a);
+        auto storedR = db.getEventById("R");
+        assert(storedR->isRecurring() && storedR->getProviderEventId() == "g-R" && storedR->getCategory() == "work");
+        assert(db.getEventById("A")->getTitle() == "Dentist (moved)");
+
+        // A whole-event update of a one-time event writes only what differs
+        OneTimeEvent later("A", "d", "Dentist (moved)", t + hours(2), hours(1));
+        assert(m.updateEvent("A", later));
+        assert(rowidOf(path, "A") == a && db.getEventById("A")->getTime() == t + hours(2));
+
+        // Through the journal too
+        WriteBehindScheduleDatabase journal(std::make_shared<SQLiteScheduleDatabase>(path));
+        Model j(&journal);
+        assert(j.updateEventFields("A", {{"category", "health"}}));
+        journal.flush();
+        assert(rowidOf(path, "A") == a && db.getEventById("A")->getCategory() == "health");
+    }
+    std::remove(path);
+}
+
 int main()
 {
     testRecurringPersistence();
@@ -250,8 +833,21 @@ int main()
     testWeeklyPersistence();
     testMonthlyPersistence();
     testYearlyPersistence();
+    testRRulePersistence();
     testRemoveAllDatabase();
     testRemoveBeforeDatabase();
+    testWriteBehindBatchesAndFlushes();
+    testWriteBehindCommitFailures();
+    testWriteBehindTransactions();
+    testPagedLoading();
+    testPagedRangeRemoval();
+    testRenameOntoExistingId();
+    testTombstones();
+    testTombstoneMovesAreAtomic();
+    testUpdatesFollowTheStore();
+    testBulkOperations();
+    testBulkWritesAreAtomic();
+    testPartialUpdates();
     cout << "Database tests passed\n";
     return 0;
 }
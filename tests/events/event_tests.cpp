@@ -9,6 +9,7 @@
 #include "../../scheduler/ScheduledTask.h"
 #include "../test_utils.h"
 #include <memory>
+#include <thread>
 
 using namespace std;
 using namespace chrono;
@@ -56,11 +57,48 @@ static void testScheduledTaskCustomTimes()
     assert(tmulti.getNextNotifyTime() == exec - minutes(30));
 }
 
+static void testInternedNames()
+{
+    auto tp = makeTime(2025,1,1,12);
+    OneTimeEvent a("a","d","t", tp, hours(1), "work");
+    OneTimeEvent b("b","d","t", tp, hours(1), "work");
+    assert(a.getCategoryHandle() == b.getCategoryHandle());
+    assert(&a.getCategory() == &b.getCategory());
+    assert(a.getCategory() == "work");
+
+    OneTimeEvent none("n","d","t", tp, hours(1));
+    assert(none.getCategoryHandle() == InternPool::kEmpty && none.getCategory().empty());
+    assert(none.getNotifierName().empty() && none.getActionName().empty());
+
+    a.setNotifierName("email");
+    a.setActionName("ping");
+    auto copy = a.clone();
+    assert(copy->getNotifierHandle() == a.getNotifierHandle());
+    assert(copy->getActionName() == "ping");
+    a.setCategory("home");
+    assert(a.getCategory() == "home" && copy->getCategory() == "work");
+
+    // Concurrent interning of the same names agrees on one handle each
+    std::vector<InternPool::Handle> seen(4);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+        threads.emplace_back([&, i]
+                             {
+            for (int n = 0; n < 2000; ++n)
+                InternPool::intern("name_" + std::to_string(n));
+            seen[i] = InternPool::intern("name_1999"); });
+    for (auto &t : threads)
+        t.join();
+    for (auto h : seen)
+        assert(h == seen[0] && InternPool::str(h) == "name_1999");
+}
+
 int main()
 {
     testOneTimeEvent();
     testRecurringEventDelegation();
     testScheduledTaskCustomTimes();
+    testInternedNames();
     cout << "Event tests passed\n";
     return 0;
 }
@@ -7,7 +7,14 @@
 #include "../../model/recurrence/WeeklyRecurrence.h"
 #include "../test_utils.h"
 #include "../../utils/TimeUtils.h"
+#include "../../utils/EditDistance.h"
+#include "../../utils/IdGenerator.h"
+#include "../../model/ChangeLog.h"
+#include <map>
 #include <memory>
+#include <random>
+#include <set>
+#include <thread>
 
 using namespace std;
 using namespace chrono;
@@ -93,6 +100,606 @@ static void testModelRemoveBefore()
     assert(list.size() == 1 && list[0].getId() == "3");
 }
 
+static void testModelIdIndexStaysInSync()
+{
+    Model m;
+    OneTimeEvent e1("1","d","t", makeTime(2025,6,1,9), hours(1));
+    OneTimeEvent e2("2","d","t", makeTime(2025,6,2,9), hours(1));
+    OneTimeEvent e3("3","d","t", makeTime(2025,6,3,9), hours(1));
+    m.addEvent(e1); m.addEvent(e2); m.addEvent(e3);
+
+    // Moving an event in time must keep it reachable by ID
+    OneTimeEvent moved("2","d","moved", makeTime(2025,6,5,9), hours(1));
+    assert(m.updateEvent("2", moved));
+    auto byId = m.getEventById("2");
+    assert(byId && byId->getTitle() == "moved" && byId->getTime() == makeTime(2025,6,5,9));
+
+    assert(m.updateEventFields("3", {{"title", "renamed"}}));
+    assert(m.getEventById("3")->getTitle() == "renamed");
+
+    // Soft delete drops the ID from the active index, restore brings it back
+    assert(m.removeEvent("1", true));
+    assert(!m.getEventById("1"));
+    assert(m.addEvent(e1) == true);
+    assert(!m.restoreEvent("1")); // ID reused meanwhile
+    assert(m.removeEvent("1"));
+    assert(m.restoreEvent("1"));
+    assert(m.getEventById("1"));
+    assert(m.getDeletedEvents().empty());
+
+    // Range removals must also drop the IDs
+    assert(m.removeEventsBefore(makeTime(2025,6,4,0)) == 2);
+    assert(!m.getEventById("1") && !m.getEventById("3"));
+    assert(m.addEvent(e3));
+    m.removeAllEvents();
+    assert(!m.getEventById("2") && !m.getEventById("3"));
+}
+
+static void testConflictsUseIntervalIndex()
+{
+    Model m;
+    OneTimeEvent a("A","d","t", makeTime(2025,6,1,9), hours(1));
+    OneTimeEvent longOne("L","d","t", makeTime(2025,6,1,6), hours(5));
+    OneTimeEvent later("B","d","t", makeTime(2025,6,1,13), hours(1));
+    m.addEvent(a); m.addEvent(longOne); m.addEvent(later);
+
+    auto c = m.getConflicts(makeTime(2025,6,1,9,30), minutes(30));
+    assert(c.size() == 2); // A and the long event that started earlier
+    assert(m.getConflicts(makeTime(2025,6,1,11), minutes(120)).empty()); // touching ends don't overlap
+
+    // A bounded daily series only conflicts on actual occurrences
+    auto start = makeTime(2025,6,2,8);
+    auto pat = std::make_shared<DailyRecurrence>(start, 1, 3);
+    m.addEvent(RecurringEvent("R","d","t", start, hours(1), pat));
+    auto hit = m.getConflicts(makeTime(2025,6,3,8,30), minutes(10));
+    assert(hit.size() == 1 && hit[0].getId() == "R" && hit[0].getTime() == makeTime(2025,6,3,8));
+    assert(m.getConflicts(makeTime(2025,6,3,12), minutes(60)).empty());
+    assert(m.getConflicts(makeTime(2025,6,5,8), minutes(60)).empty()); // past the third occurrence
+    assert(m.getConflicts(makeTime(2025,6,2,0), hours(72)).size() == 3);
+
+    // A long count must not overflow the series' end into the past
+    auto longStart = makeTime(2025,7,1,20);
+    auto longPat = std::make_shared<DailyRecurrence>(longStart, 1, 200000);
+    m.addEvent(RecurringEvent("LONG","d","t", longStart, minutes(30), longPat));
+    auto farHit = m.getConflicts(makeTime(2025,10,9,20,10), minutes(5));
+    assert(farHit.size() == 1 && farHit[0].getId() == "LONG");
+    assert(m.removeEvent("LONG"));
+
+    OneTimeEvent probe("P","d","t", makeTime(2025,6,4,8,15), minutes(15));
+    assert(!m.validateEventTime(probe));
+    probe.setTime(makeTime(2025,6,4,10));
+    assert(m.validateEventTime(probe));
+
+    // Removed/moved events leave the index with them
+    assert(m.removeEvent("R"));
+    assert(m.getConflicts(makeTime(2025,6,3,8,30), minutes(10)).empty());
+    OneTimeEvent moved("A","d","t", makeTime(2025,6,10,9), hours(1));
+    assert(m.updateEvent("A", moved));
+    assert(m.getConflicts(makeTime(2025,6,1,9,30), minutes(30)).size() == 1);
+    assert(m.getConflicts(makeTime(2025,6,10,9,30), minutes(1)).size() == 1);
+    m.removeAllEvents();
+    assert(m.getConflicts(makeTime(2025,6,10,9,30), minutes(1)).empty());
+}
+
+static void testCategoryPostingLists()
+{
+    Model m;
+    OneTimeEvent a("A","d","t", makeTime(2025,6,2,9), hours(1), "work");
+    OneTimeEvent b("B","d","t", makeTime(2025,6,1,9), hours(1), "work");
+    OneTimeEvent c("C","d","t", makeTime(2025,6,3,9), hours(1), "gym");
+    OneTimeEvent d("D","d","t", makeTime(2025,6,4,9), hours(1));
+    m.addEvent(a); m.addEvent(b); m.addEvent(c); m.addEvent(d);
+
+    auto work = m.getEventsByCategory("work");
+    assert(work.size() == 2 && work[0].getId() == "B" && work[1].getId() == "A");
+    assert(m.getCategories() == std::set<std::string>({"gym", "work"}));
+    assert(m.getCategoryCounts().at("work") == 2);
+
+    // Recategorizing the last gym event drops the category
+    assert(m.updateEventFields("C", {{"category", "work"}}));
+    assert(m.getCategories() == std::set<std::string>({"work"}));
+    assert(m.getEventsByCategory("gym").empty());
+    assert(m.getCategoryCounts().at("work") == 3);
+
+    // Removals, soft deletes and restores keep counts live
+    assert(m.removeEvent("A"));
+    assert(m.removeEvent("B", true));
+    assert(m.getCategoryCounts().at("work") == 1);
+    assert(m.restoreEvent("B"));
+    assert(m.getCategoryCounts().at("work") == 2);
+    OneTimeEvent moved("C","d","t", makeTime(2025,6,9,9), hours(1), "errands");
+    assert(m.updateEvent("C", moved));
+    assert(m.getCategoryCounts() == (std::map<std::string, size_t>{{"errands", 1}, {"work", 1}}));
+    assert(m.removeEventsBefore(makeTime(2025,6,5,0)) == 2);
+    assert(m.getCategories() == std::set<std::string>({"errands"}));
+    m.removeAllEvents();
+    assert(m.getCategories().empty());
+}
+
+static void testSnapshotsAcrossChunks()
+{
+    Model m;
+    auto base = makeTime(2025,1,1,0);
+    // Interleave insert order so chunks split in the middle, not just at the tail
+    for (int i = 0; i < 3000; ++i)
+    {
+        int slot = (i * 7919) % 3000;
+        OneTimeEvent e(std::to_string(slot), "d", "t", base + minutes(slot), minutes(5));
+        assert(m.addEvent(e));
+    }
+
+    auto held = m.snapshot();
+    assert(held->size() == 3000);
+
+    // Drop two thirds so small chunks get folded back together
+    for (int i = 0; i < 3000; ++i)
+        if (i % 3 != 0)
+            assert(m.removeEvent(std::to_string(i)));
+
+    auto now = m.snapshot();
+    assert(now->size() == 1000);
+    int expected = 0;
+    for (const auto &e : *now)
+    {
+        assert(e->getId() == std::to_string(expected));
+        expected += 3;
+    }
+    auto range = m.getEventsInRange(base + minutes(300), base + minutes(330));
+    assert(range.size() == 11 && range.front().getId() == "300" && range.back().getId() == "330");
+
+    // A snapshot taken earlier is unaffected by later writes
+    assert(held->size() == 3000);
+    auto it = held->lowerBound(base + minutes(1500));
+    assert(it != held->end() && (*it)->getId() == "1500");
+    assert(held->upperBound(base + minutes(2999)) == held->end());
+}
+
+static void testRangeEraseAcrossChunks()
+{
+    Model m;
+    auto base = makeTime(2025,1,1,0);
+    for (int i = 0; i < 5000; ++i)
+        assert(m.addEvent(OneTimeEvent(std::to_string(i), "d", "t", base + minutes(i), minutes(5), "c" + std::to_string(i % 3))));
+    auto held = m.snapshot();
+
+    // Spans several whole chunks plus a partial one at each edge
+    assert(m.removeEventsBefore(base + minutes(1700)) == 1700);
+    assert(m.snapshot()->size() == 3300 && (*m.snapshot()->begin())->getId() == "1700");
+    assert(!m.getEventById("1699") && m.getEventById("1700"));
+    assert(m.getEventsByCategory("c0").size() == 1100);
+
+    EventSnapshot::Builder draft(m.snapshot());
+    assert(draft.eraseRange(base + minutes(2000), base + minutes(4000)) == 2000);
+    assert(draft.eraseRange(base + minutes(4000), base + minutes(4000)) == 0);
+    auto trimmed = draft.build();
+    assert(trimmed->size() == 1300);
+    int expected = 1700;
+    for (const auto &e : *trimmed)
+    {
+        assert(e->getId() == std::to_string(expected));
+        expected = expected == 1999 ? 4000 : expected + 1;
+    }
+    assert(expected == 5000);
+
+    // Readers holding the old snapshot still see everything
+    assert(held->size() == 5000);
+}
+
+// Daily pattern that counts how often it is expanded
+class CountingPattern : public RecurrencePattern
+{
+public:
+    CountingPattern(std::chrono::system_clock::time_point start, int interval, int maxOccurrences = -1)
+        : inner_(start, interval, maxOccurrences) {}
+    mutable int expansions = 0;
+
+    std::vector<std::chrono::system_clock::time_point> getNextNOccurrences(
+        std::chrono::system_clock::time_point after, int n) const override
+    {
+        return inner_.getNextNOccurrences(after, n);
+    }
+    std::unique_ptr<OccurrenceCursor> occurrencesFrom(std::chrono::system_clock::time_point from) const override
+    {
+        ++expansions;
+        return inner_.occurrencesFrom(from);
+    }
+    bool isDueOn(std::chrono::system_clock::time_point date) const override { return inner_.isDueOn(date); }
+    std::chrono::system_clock::time_point lastOccurrenceBound() const override { return inner_.lastOccurrenceBound(); }
+    std::string type() const override { return "daily"; }
+
+private:
+    DailyRecurrence inner_;
+};
+
+static void testOccurrenceCache()
+{
+    auto now = std::chrono::system_clock::now();
+    auto start = std::chrono::floor<std::chrono::seconds>(now) - hours(24 * 10);
+    auto pattern = std::make_shared<CountingPattern>(start, 1);
+    Model m;
+    m.addEvent(RecurringEvent("R", "d", "daily", start, hours(1), pattern));
+
+    // The first view query fills the cache; the rest are lookups
+    pattern->expansions = 0;
+    auto day = m.getEventsOnDay(now + hours(24 * 3));
+    assert(day.size() == 1);
+    assert(m.getEventsInWeek(now).size() == 7);
+    assert(m.getEventsInMonth(now + hours(24 * 30)).size() >= 28);
+    m.findFreeSlots(now + hours(24 * 5), 8, 18, 30);
+    assert(pattern->expansions == 1);
+
+    // Past the horizon the cache is extended once, then reused
+    auto far = now + hours(24 * 200);
+    assert(m.getEventsOnDay(far).size() == 1);
+    assert(m.getEventsOnDay(far).size() == 1);
+    assert(pattern->expansions == 2);
+
+    // A new pattern brings a new cache
+    RecurringEvent updated("R", "d", "daily", start, hours(1), pattern);
+    updated.setRecurrencePattern(std::make_shared<DailyRecurrence>(start, 2));
+    assert(m.updateEvent("R", updated));
+    int hits = 0;
+    for (int i = 0; i < 4; ++i)
+        hits += static_cast<int>(m.getEventsOnDay(now + hours(24 * i)).size());
+    assert(hits == 2);
+    assert(pattern->expansions == 2);
+
+    // A span too wide to cache is expanded once, then refused up front,
+    // as is any span covering it
+    OccurrenceCache cache;
+    auto dense = std::make_shared<CountingPattern>(start, 1);
+    OccurrenceCache::Slice week;
+    auto wideEnd = now + hours(24 * 20000);
+    assert(!cache.lookup(*dense, start, wideEnd, week));
+    assert(!cache.lookup(*dense, start, wideEnd, week));
+    assert(!cache.lookup(*dense, start - hours(24), wideEnd, week));
+    assert(dense->expansions == 1);
+    auto from = now + hours(1);
+    assert(cache.lookup(*dense, from, from + hours(24 * 7), week) && week.size() == 7);
+    assert(dense->expansions == 2);
+
+    // Extending keeps slices already handed out intact
+    auto first = *week.begin();
+    OccurrenceCache::Slice later;
+    assert(cache.lookup(*dense, from + hours(24 * 300), from + hours(24 * 307), later) && later.size() == 7);
+    assert(week.size() == 7 && *week.begin() == first && *later.begin() == first + hours(24 * 300));
+    assert(dense->expansions == 3);
+    // A failed extension leaves the cached array as it was. (Reaching
+    // wideEnd would be refused up front, as it covers the first span.)
+    auto tooFar = now + hours(24 * 18000);
+    assert(!cache.lookup(*dense, from, tooFar, later));
+    assert(!cache.lookup(*dense, from, tooFar, later));
+    assert(dense->expansions == 4);
+    assert(cache.lookup(*dense, from + hours(24 * 300), from + hours(24 * 307), later) && later.size() == 7);
+    assert(dense->expansions == 4);
+}
+
+static void testRangeSkipsFinishedSeries()
+{
+    Model m;
+    std::vector<std::shared_ptr<CountingPattern>> finished;
+    for (int i = 0; i < 20; ++i)
+    {
+        auto start = makeTime(2010, 1, 1 + i, 9);
+        finished.push_back(std::make_shared<CountingPattern>(start, 1, 5));
+        m.addEvent(RecurringEvent("old" + std::to_string(i), "d", "t", start, hours(1), finished.back()));
+        m.addEvent(OneTimeEvent("past" + std::to_string(i), "d", "t", start, hours(1)));
+    }
+    auto start = makeTime(2025, 6, 1, 9);
+    auto live = std::make_shared<CountingPattern>(start, 1);
+    m.addEvent(RecurringEvent("live", "d", "t", start, hours(1), live));
+    m.addEvent(OneTimeEvent("once", "d", "t", makeTime(2025, 6, 3, 12), hours(1)));
+    // Ends exactly where the window starts, at a zero-length occurrence
+    auto edge = std::make_shared<CountingPattern>(makeTime(2025, 5, 30, 0), 1, 3);
+    m.addEvent(RecurringEvent("edge", "d", "t", makeTime(2025, 5, 30, 0), hours(0), edge));
+
+    for (auto &p : finished)
+        p->expansions = 0;
+    auto events = m.getEventsInRangeExpanded(makeTime(2025, 6, 1, 0), makeTime(2025, 6, 4, 0));
+    assert(events.size() == 5);
+    assert(events[0].getId() == "edge" && events[0].getTime() == makeTime(2025, 6, 1, 0));
+    assert(events[1].getId() == "live" && events[4].getId() == "once");
+    for (auto &p : finished)
+        assert(p->expansions == 0);
+
+    // Finished series still answer for their own years
+    assert(m.getEventsInRangeExpanded(makeTime(2010, 1, 1), makeTime(2010, 1, 4)).size() == 6 + 3);
+}
+
+static void testNextNMergesSeries()
+{
+    Model m;
+    auto now = std::chrono::floor<std::chrono::seconds>(chrono::system_clock::now());
+    std::vector<std::chrono::system_clock::time_point> expected;
+    for (int i = 0; i < 6; ++i)
+    {
+        auto start = now - hours(24 * 30) + minutes(7 * i);
+        auto pattern = std::make_shared<DailyRecurrence>(start, 1 + i);
+        m.addEvent(RecurringEvent("S" + std::to_string(i), "d", "t", start, minutes(5), pattern));
+        for (auto t : pattern->getNextNOccurrences(now - seconds(1), 40))
+            expected.push_back(t);
+    }
+    // A series that finished long ago never enters the merge
+    auto old = now - hours(24 * 400);
+    m.addEvent(RecurringEvent("done", "d", "t", old, minutes(5), std::make_shared<DailyRecurrence>(old, 1, 3)));
+    for (int i = 0; i < 30; ++i)
+    {
+        auto t = now + hours(5 * i) + minutes(3);
+        m.addEvent(OneTimeEvent("O" + std::to_string(i), "d", "t", t, minutes(1)));
+        expected.push_back(t);
+        m.addEvent(OneTimeEvent("P" + std::to_string(i), "d", "t", now - hours(5 * i + 1), minutes(1)));
+    }
+    std::sort(expected.begin(), expected.end());
+
+    auto next = m.getNextOccurrences(25);
+    assert(next.size() == 25);
+    for (size_t i = 0; i < next.size(); ++i)
+    {
+        assert(next[i].start == expected[i]);
+        assert(next[i].series->getId() != "done" && next[i].series->getId()[0] != 'P');
+    }
+    // Each series numbers its own occurrences in order
+    std::map<std::string, uint32_t> seen;
+    for (const auto &o : next)
+        if (o.series->isRecurring())
+            assert(o.index == seen[o.series->getId()]++);
+}
+
+static void testParallelExpansionMatchesSerial()
+{
+    Model m;
+    auto base = makeTime(2024, 1, 1, 6);
+    for (int i = 0; i < 40; ++i)
+    {
+        auto start = base + minutes(13 * i);
+        m.addEvent(RecurringEvent("S" + std::to_string(i), "d", "t", start, minutes(10),
+                                  std::make_shared<DailyRecurrence>(start, 1 + i % 3)));
+    }
+    for (int i = 0; i < 500; ++i)
+        m.addEvent(OneTimeEvent("O" + std::to_string(i), "d", "t", base + hours(17 * i) + seconds(30), minutes(5)));
+
+    auto from = makeTime(2024, 2, 1);
+    auto to = makeTime(2024, 12, 1);
+    m.setParallelExpansion(0);
+    auto serial = m.getOccurrencesInRange(from, to);
+    m.setParallelExpansion(1, 4);
+    auto parallel = m.getOccurrencesInRange(from, to);
+
+    assert(serial.size() > 5000);
+    assert(parallel.size() == serial.size());
+    for (size_t i = 0; i < serial.size(); ++i)
+    {
+        assert(parallel[i].start == serial[i].start);
+        assert(parallel[i].series == serial[i].series);
+        assert(parallel[i].index == serial[i].index);
+    }
+}
+
+static void testChangeLogDeltas()
+{
+    // The ring keeps the newest records and refuses versions it has lost
+    ChangeLog log(3);
+    auto v0 = log.version();
+    for (const char *id : {"a", "b", "c", "d"})
+        log.record(ChangeLog::Kind::Upsert, id);
+    std::vector<ChangeLog::Record> out;
+    assert(!log.since(v0, out));
+    assert(log.since(v0 + 1, out) && out.size() == 3 && out.front().id == "b" && out.back().id == "d");
+    out.clear();
+    assert(log.since(log.version(), out) && out.empty());
+    assert(!log.since(log.version() + 1, out));
+
+    Model m;
+    auto t = makeTime(2025,6,2,9);
+    m.addEvent(OneTimeEvent("1", "d", "one", t, hours(1)));
+    m.addEvent(OneTimeEvent("2", "d", "two", t + hours(1), hours(1)));
+    auto seen = m.changeVersion();
+    m.updateEventFields("1", {{"title", "uno"}});
+    m.addEvent(OneTimeEvent("3", "d", "three", t + hours(2), hours(1)));
+    m.removeEvent("2");
+    m.addEvent(OneTimeEvent("4", "d", "gone", t, hours(1)));
+    m.removeEvent("4", true);
+
+    // Each ID once, under its latest change
+    auto delta = m.getChangesSince(seen);
+    assert(!delta.resync && delta.version == m.changeVersion());
+    assert(delta.upserts.size() == 2 && delta.upserts[0]->getTitle() == "uno" && delta.upserts[1]->getId() == "3");
+    assert(std::set<std::string>(delta.deletes.begin(), delta.deletes.end()) == std::set<std::string>({"2", "4"}));
+    assert(m.getChangesSince(delta.version).upserts.empty());
+
+    // Clearing everything is not listed; clients behind it resync
+    m.removeAllEvents();
+    assert(m.getChangesSince(delta.version).resync);
+    assert(!m.getChangesSince(m.changeVersion()).resync);
+}
+
+static void testSnapshotHotFields()
+{
+    Model m;
+    auto base = makeTime(2025,3,1,9);
+    OneTimeEvent a("A","d","t", base, minutes(30), "work");
+    auto rec = std::make_shared<DailyRecurrence>(base + hours(1), 1);
+    RecurringEvent r("R","d","t", base + hours(1), hours(2), rec, "gym");
+    assert(m.addEvent(a) && m.addEvent(r));
+
+    auto snap = m.snapshot();
+    auto it = snap->begin();
+    assert(it.start() == base && it.duration() == minutes(30) && !it.isRecurring());
+    assert(InternPool::str(it.categoryId()) == "work");
+    ++it;
+    assert(it.start() == base + hours(1) && it.duration() == hours(2) && it.isRecurring());
+    assert(it.categoryId() == InternPool::intern("gym"));
+
+    // In-place edits refresh the hot columns alongside the event
+    assert(m.updateEventFields("A", {{"category", "home"}}));
+    auto first = m.snapshot()->begin();
+    assert((*first)->getCategory() == "home");
+    assert(first.categoryId() == InternPool::intern("home"));
+    assert(InternPool::str(snap->begin().categoryId()) == "work");
+
+    auto byDuration = m.getEventsByDuration(60, 180);
+    assert(byDuration.size() == 1 && byDuration[0].getId() == "R");
+}
+
+static void testBorrowedResults()
+{
+    Model m;
+    auto base = makeTime(2025,4,1,9);
+    OneTimeEvent a("A","d","t", base, minutes(30), "work");
+    auto rec = std::make_shared<DailyRecurrence>(base + hours(2), 1);
+    RecurringEvent r("R","d","t", base + hours(2), hours(1), rec, "gym");
+    assert(m.addEvent(a) && m.addEvent(r));
+
+    // Borrowed results are the stored objects, not copies
+    auto snap = m.snapshot();
+    auto all = m.getEventPtrs(-1, base + hours(24));
+    assert(all.size() == 2 && all[0] == *snap->begin());
+    auto range = m.getEventPtrsInRange(base, base + hours(3));
+    assert(range.size() == 2 && range[1].get() == all[1].get());
+    assert(m.getEventPtrsByCategory("work").at(0) == all[0]);
+    assert(m.getEventPtrsByDuration(50, 70).at(0)->getId() == "R");
+
+    // Recurring entries keep their dynamic type instead of slicing to Event
+    auto expanded = m.getEventPtrsInRangeExpanded(base, base + hours(72));
+    assert(expanded.size() == 4);
+    const auto *occ = dynamic_cast<const RecurringEvent *>(expanded[1].get());
+    assert(occ && occ->getRecurrencePattern() == rec && occ->getCategory() == "gym");
+
+    // Held results outlive removal from the model
+    assert(m.removeEvent("A"));
+    assert(all[0]->getId() == "A" && m.getEventPtrs(-1, base + hours(24)).size() == 1);
+}
+
+static void testOccurrencesShareSeries()
+{
+    Model m;
+    auto start = makeTime(2025,5,5,9);
+    auto rec = std::make_shared<DailyRecurrence>(start, 1);
+    RecurringEvent standup("S","daily sync","Standup", start, minutes(15), rec, "meetings");
+    OneTimeEvent review("V","d","Review", makeTime(2025,5,6,10), hours(1));
+    assert(m.addEvent(standup) && m.addEvent(review));
+
+    auto occ = m.getOccurrencesInRange(makeTime(2025,5,6,0), makeTime(2025,5,9,0));
+    assert(occ.size() == 4);
+    assert(occ[0].start == makeTime(2025,5,6,9) && occ[0].index == 0);
+    assert(occ[1].event().getId() == "V" && occ[1].end() == makeTime(2025,5,6,11));
+    assert(occ[2].index == 1 && occ[3].index == 2);
+    // Every occurrence points at the one stored series
+    assert(occ[0].series == occ[3].series && occ[0].series == *m.snapshot()->begin());
+
+    auto copy = occ[3].materialize();
+    assert(copy.getTime() == makeTime(2025,5,8,9) && copy.getCategory() == "meetings" && copy.isRecurring());
+
+    auto day = m.getOccurrencesOnDay(makeTime(2025,5,6,12));
+    assert(day.size() == 2 && day[0].event().getId() == "S" && day[1].event().getId() == "V");
+    auto next = m.getNextOccurrences(3);
+    assert(next.size() == 3 && next[0].start < next[1].start);
+}
+
+static void testSearchIndex()
+{
+    Model m;
+    OneTimeEvent a("A","Quarterly budget review","Finance Meeting", makeTime(2025,6,2,9), hours(1));
+    OneTimeEvent b("B","Weekly sync, room 4B","Team Meeting", makeTime(2025,6,1,9), hours(1));
+    OneTimeEvent c("C","o'clock","Dentist", makeTime(2025,6,3,9), hours(1));
+    assert(m.addEvent(a) && m.addEvent(b) && m.addEvent(c));
+
+    // Substring, case and punctuation folding; results in time order
+    auto hits = m.searchEvents("MEET");
+    assert(hits.size() == 2 && hits[0].getId() == "B" && hits[1].getId() == "A");
+    assert(m.searchEvents("oclock").at(0).getId() == "C");
+    // Fuzzy: "budgte" is within half its length of "budget"
+    assert(m.searchEvents("budgte").at(0).getId() == "A");
+    assert(m.searchEvents("xyzzy").empty());
+    // Every query word must match some word of the event
+    hits = m.searchEvents("meeting 4b");
+    assert(hits.size() == 1 && hits[0].getId() == "B");
+    assert(m.searchEvents("meeting", 1).size() == 1);
+    assert(m.searchEvents("  !! ").size() == 3);
+
+    // Edits and removals are reflected immediately
+    assert(m.updateEventFields("C", {{"title", "Orthodontist"}}));
+    assert(m.searchEvents("dentist").at(0).getTitle() == "Orthodontist");
+    assert(m.removeEvent("A"));
+    assert(m.searchEvents("budget").empty());
+    m.removeAllEvents();
+    assert(m.searchEvents("meeting").empty());
+}
+
+static void testBoundedEditDistance()
+{
+    auto reference = [](const std::string &a, const std::string &b)
+    {
+        std::vector<size_t> prev(b.size() + 1), row(b.size() + 1);
+        for (size_t j = 0; j <= b.size(); ++j)
+            prev[j] = j;
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            row[0] = i + 1;
+            for (size_t j = 0; j < b.size(); ++j)
+                row[j + 1] = std::min({prev[j + 1] + 1, row[j] + 1, prev[j] + (a[i] == b[j] ? 0 : 1)});
+            prev.swap(row);
+        }
+        return prev[b.size()];
+    };
+
+    BoundedEditDistance kitten("kitten");
+    assert(kitten.within("sitting", 3) && !kitten.within("sitting", 2));
+    assert(BoundedEditDistance("").within("abc", 3) && !BoundedEditDistance("").within("abc", 2));
+
+    // Agree with the full DP on both sides of every cutoff, including
+    // patterns longer than one machine word
+    std::mt19937 rng(11);
+    for (int n = 0; n < 3000; ++n)
+    {
+        auto word = [&](size_t maxLen)
+        {
+            std::string w(rng() % (maxLen + 1), 'a');
+            for (auto &c : w)
+                c = static_cast<char>('a' + rng() % 4);
+            return w;
+        };
+        size_t maxLen = n % 10 == 0 ? 90 : 12;
+        std::string a = word(maxLen), b = word(maxLen);
+        BoundedEditDistance kernel(a);
+        size_t d = reference(a, b);
+        assert(kernel.within(b, d));
+        assert(d == 0 || !kernel.within(b, d - 1));
+    }
+}
+
+static void testGeneratedIdsAreOrdered()
+{
+    Model m;
+    const int THREADS = 4, PER_THREAD = 20000;
+    std::vector<std::vector<std::string>> ids(THREADS);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t)
+        threads.emplace_back([&, t]
+                             {
+            for (int i = 0; i < PER_THREAD; ++i)
+                ids[t].push_back(m.generateUniqueId()); });
+    for (auto &t : threads)
+        t.join();
+
+    std::set<std::string> all;
+    for (const auto &list : ids)
+    {
+        // Each caller sees strictly increasing, fixed-width IDs
+        for (size_t i = 1; i < list.size(); ++i)
+            assert(list[i - 1] < list[i]);
+        // Base32hex only, so the IDs are valid Google Calendar event IDs
+        for (const auto &id : list)
+            assert(id.size() == IdGenerator::kLength &&
+                   id.find_first_not_of("0123456789abcdefghijklmnopqrstuv") == std::string::npos);
+        all.insert(list.begin(), list.end());
+    }
+    assert(all.size() == size_t(THREADS * PER_THREAD));
+
+    // Later calls sort after earlier ones across threads too
+    assert(m.generateUniqueId() > *all.rbegin());
+}
+
 static void testModelGetEventsLimit()
 {
     Model m;
@@ -315,6 +922,22 @@ int main()
     testModelRemoveDay();
     testModelRemoveWeek();
     testModelRemoveBefore();
+    testModelIdIndexStaysInSync();
+    testConflictsUseIntervalIndex();
+    testCategoryPostingLists();
+    testSnapshotsAcrossChunks();
+    testRangeEraseAcrossChunks();
+    testChangeLogDeltas();
+    testOccurrenceCache();
+    testRangeSkipsFinishedSeries();
+    testNextNMergesSeries();
+    testParallelExpansionMatchesSerial();
+    testSnapshotHotFields();
+    testBorrowedResults();
+    testOccurrencesShareSeries();
+    testSearchIndex();
+    testBoundedEditDistance();
+    testGeneratedIdsAreOrdered();
     testModelGetEventsLimit();
     testModelWithDailyRecurring();
     testNextNWithRecurring();
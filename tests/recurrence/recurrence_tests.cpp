@@ -2,10 +2,12 @@
 #include <iostream>
 #include <vector>
 #include <ctime>
+#include <stdexcept>
 #include "../../model/recurrence/DailyRecurrence.h"
 #include "../../model/recurrence/WeeklyRecurrence.h"
 #include "../../model/recurrence/MonthlyRecurrence.h"
 #include "../../model/recurrence/YearlyRecurrence.h"
+#include "../../model/recurrence/RRuleRecurrence.h"
 #include "../../utils/WeekDay.h"
 #include "../../utils/TimeUtils.h"
 
@@ -162,6 +164,285 @@ void testRecurringCrossTimeZones()
     tzset();
 }
 
+// Seeking straight to the first occurrence after a point must agree with
+// walking the series from its start, including the count and end clamps.
+static void checkSeek(const RecurrencePattern &rec, const vector<system_clock::time_point> &expected)
+{
+    assert(rec.getNextNOccurrences(system_clock::time_point::min(), 100000) == expected);
+    for (size_t i = 0; i < expected.size(); i += 7)
+    {
+        auto at = rec.getNextNOccurrences(expected[i] - seconds(1), 1);
+        assert(at.size() == 1 && at[0] == expected[i]);
+        auto next = rec.getNextNOccurrences(expected[i], 3);
+        assert(next.size() == std::min<size_t>(3, expected.size() - i - 1));
+        for (size_t k = 0; k < next.size(); ++k)
+            assert(next[k] == expected[i + 1 + k]);
+    }
+    assert(rec.getNextNOccurrences(expected.back(), 5).empty());
+    assert(rec.lastOccurrenceBound() == expected.back());
+}
+
+void testSeekMatchesWalk()
+{
+    const char* prevPtr = getenv("TZ");
+    std::string prev = prevPtr ? std::string(prevPtr) : std::string();
+    bool hadPrev = prevPtr != nullptr;
+    setenv("TZ", "UTC", 1);
+    tzset();
+
+    auto leap = [](int y) { return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0; };
+    auto monthDays = [&](int y, int m) {
+        static const int days[] = {31,28,31,30,31,30,31,31,30,31,30,31};
+        return m == 2 && leap(y) ? 29 : days[m - 1];
+    };
+
+    auto dailyStart = makeTime(1999, 12, 31, 23, 15) + milliseconds(250);
+    vector<system_clock::time_point> daily;
+    for (int i = 0; i < 2000; ++i)
+        daily.push_back(dailyStart + hours(72) * i);
+    checkSeek(DailyRecurrence(dailyStart, 3, 2000), daily);
+
+    // Starts on a Wednesday, so that week's Monday is not an occurrence
+    auto weeklyStart = makeTime(2003, 1, 1, 8);
+    vector<system_clock::time_point> weekly;
+    for (int d = 0; weekly.size() < 500; ++d)
+    {
+        int weekday = (3 + d) % 7;
+        if (((3 + d) / 7) % 2 == 0 && (weekday == 1 || weekday == 3 || weekday == 5))
+            weekly.push_back(weeklyStart + hours(24) * d);
+    }
+    checkSeek(WeeklyRecurrence(weeklyStart, {Weekday::Friday, Weekday::Monday, Weekday::Wednesday}, 2, 500), weekly);
+
+    auto monthlyEnd = makeTime(2020, 6, 1);
+    vector<system_clock::time_point> monthly;
+    for (int i = 0; i < 300; ++i)
+    {
+        int y = 2001 + i / 12, m = 1 + i % 12;
+        auto t = makeTime(y, m, std::min(31, monthDays(y, m)), 9, 30);
+        if (t <= monthlyEnd)
+            monthly.push_back(t);
+    }
+    assert(monthly.size() < 300);
+    checkSeek(MonthlyRecurrence(makeTime(2001, 1, 31, 9, 30), 1, 300, monthlyEnd), monthly);
+
+    vector<system_clock::time_point> yearly;
+    for (int y = 2000; y < 2090; y += 3)
+        yearly.push_back(makeTime(y, 2, leap(y) ? 29 : 28, 10));
+    checkSeek(YearlyRecurrence(makeTime(2000, 2, 29, 10), 3, 30), yearly);
+
+    if (hadPrev)
+        setenv("TZ", prev.c_str(), 1);
+    else
+        unsetenv("TZ");
+    tzset();
+}
+
+// Pattern that only knows getNextNOccurrences, to exercise the paged default
+class HourlyPattern : public RecurrencePattern
+{
+public:
+    explicit HourlyPattern(system_clock::time_point start) : start_(start) {}
+    mutable int requested = 0;
+
+    vector<system_clock::time_point> getNextNOccurrences(system_clock::time_point after, int n) const override
+    {
+        requested += n;
+        vector<system_clock::time_point> out;
+        auto t = after < start_ ? start_ : start_ + hours((after - start_) / hours(1) + 1);
+        for (int i = 0; i < n; ++i)
+            out.push_back(t + hours(i));
+        return out;
+    }
+    bool isDueOn(system_clock::time_point) const override { return false; }
+    std::string type() const override { return "hourly"; }
+
+private:
+    system_clock::time_point start_;
+};
+
+void testOccurrencesBetween()
+{
+    auto start = makeTime(2000, 1, 1, 9);
+    DailyRecurrence daily(start, 1);
+
+    // [start, end): an occurrence exactly at `start` is in, one at `end` is out
+    vector<system_clock::time_point> seen;
+    for (auto t : daily.occurrencesBetween(makeTime(2025, 6, 1, 9), makeTime(2025, 6, 4, 9)))
+        seen.push_back(t);
+    assert(seen.size() == 3);
+    assert(seen[0] == makeTime(2025, 6, 1, 9));
+    assert(seen[2] == makeTime(2025, 6, 3, 9));
+
+    int count = 0;
+    for (auto t : daily.occurrencesBetween(makeTime(2025, 6, 1, 10), makeTime(2025, 6, 2, 10)))
+    {
+        assert(t == makeTime(2025, 6, 2, 9));
+        ++count;
+    }
+    assert(count == 1);
+
+    MonthlyRecurrence monthly(makeTime(2024, 1, 31, 9), 1, 4);
+    seen.clear();
+    for (auto t : monthly.occurrencesBetween(system_clock::time_point::min(), system_clock::time_point::max()))
+        seen.push_back(t);
+    assert(seen == monthly.getNextNOccurrences(system_clock::time_point::min(), 10));
+
+    // The default pages lazily: a short window asks for one small page
+    HourlyPattern hourly(start);
+    count = 0;
+    for (auto t : hourly.occurrencesBetween(start + hours(5), start + hours(8)))
+    {
+        assert(t == start + hours(5 + count));
+        ++count;
+    }
+    assert(count == 3);
+    assert(hourly.requested <= 16);
+}
+
+static vector<system_clock::time_point> firstN(const RecurrencePattern &p, int n)
+{
+    return p.getNextNOccurrences(system_clock::time_point::min(), n);
+}
+
+static bool rejects(const std::string &rule)
+{
+    try
+    {
+        RRuleRecurrence r(makeTime(2025, 1, 1, 9), rule);
+    }
+    catch (const std::runtime_error &)
+    {
+        return true;
+    }
+    return false;
+}
+
+void testRRuleConformance()
+{
+    // Second Tuesday of the month
+    RRuleRecurrence secondTuesday(makeTime(2025, 1, 1, 9), "RRULE:FREQ=MONTHLY;BYDAY=2TU;COUNT=4");
+    vector<system_clock::time_point> expected = {makeTime(2025, 1, 14, 9), makeTime(2025, 2, 11, 9),
+                                                 makeTime(2025, 3, 11, 9), makeTime(2025, 4, 8, 9)};
+    assert(firstN(secondTuesday, 10) == expected);
+    assert(secondTuesday.lastOccurrenceBound() == makeTime(2025, 4, 8, 9));
+
+    // Last day of the month, through a leap February
+    RRuleRecurrence lastDay(makeTime(2024, 1, 15, 18), "FREQ=MONTHLY;BYMONTHDAY=-1");
+    expected = {makeTime(2024, 1, 31, 18), makeTime(2024, 2, 29, 18), makeTime(2024, 3, 31, 18),
+                makeTime(2024, 4, 30, 18)};
+    assert(firstN(lastDay, 4) == expected);
+
+    // Last weekday of the month
+    RRuleRecurrence lastWeekday(makeTime(2025, 1, 1, 9), "FREQ=MONTHLY;BYDAY=MO,TU,WE,TH,FR;BYSETPOS=-1");
+    expected = {makeTime(2025, 1, 31, 9), makeTime(2025, 2, 28, 9), makeTime(2025, 3, 31, 9),
+                makeTime(2025, 4, 30, 9), makeTime(2025, 5, 30, 9)};
+    assert(firstN(lastWeekday, 5) == expected);
+
+    // Ordinals count within BYMONTH, or through the year without it
+    RRuleRecurrence thanksgiving(makeTime(2024, 1, 1, 12), "FREQ=YEARLY;BYMONTH=11;BYDAY=4TH");
+    expected = {makeTime(2024, 11, 28, 12), makeTime(2025, 11, 27, 12), makeTime(2026, 11, 26, 12)};
+    assert(firstN(thanksgiving, 3) == expected);
+    RRuleRecurrence twentiethMonday(makeTime(1997, 1, 1, 9), "FREQ=YEARLY;BYDAY=20MO");
+    expected = {makeTime(1997, 5, 19, 9), makeTime(1998, 5, 18, 9), makeTime(1999, 5, 17, 9)};
+    assert(firstN(twentiethMonday, 3) == expected);
+
+    // Unlike MonthlyRecurrence, days a month lacks are skipped, not clamped
+    RRuleRecurrence thirtyFirst(makeTime(2025, 1, 31, 9), "FREQ=MONTHLY;COUNT=3");
+    expected = {makeTime(2025, 1, 31, 9), makeTime(2025, 3, 31, 9), makeTime(2025, 5, 31, 9)};
+    assert(firstN(thirtyFirst, 10) == expected);
+    RRuleRecurrence leapDay(makeTime(2024, 2, 29, 9), "FREQ=YEARLY");
+    assert(firstN(leapDay, 2)[1] == makeTime(2028, 2, 29, 9));
+
+    // A bare UNTIL date keeps the whole day
+    RRuleRecurrence until(makeTime(2025, 1, 1, 9), "FREQ=DAILY;UNTIL=20250105");
+    assert(firstN(until, 10).size() == 5);
+    assert(until.isDueOn(makeTime(2025, 1, 5, 9)));
+    assert(!until.isDueOn(makeTime(2025, 1, 6, 9)));
+
+    // Excluded dates drop out but still use up the count
+    RRuleRecurrence excluded(makeTime(2025, 1, 1, 9), "RRULE:FREQ=WEEKLY;COUNT=4\nEXDATE:20250108T090000Z",
+                             {makeTime(2025, 1, 22, 9)});
+    expected = {makeTime(2025, 1, 1, 9), makeTime(2025, 1, 15, 9)};
+    assert(firstN(excluded, 10) == expected);
+    RRuleRecurrence excludedDay(makeTime(2025, 1, 1, 9), "FREQ=DAILY\nEXDATE:20250102");
+    assert(firstN(excludedDay, 2)[1] == makeTime(2025, 1, 3, 9));
+    assert(excludedDay.getExdates().front() == makeTime(2025, 1, 2, 9));
+
+    // A rule no date satisfies ends rather than searching forever
+    RRuleRecurrence never(makeTime(2025, 1, 1, 9), "FREQ=YEARLY;BYMONTH=2;BYMONTHDAY=30");
+    assert(firstN(never, 1).empty());
+    assert(never.lastOccurrenceBound() == makeTime(2025, 1, 1, 9));
+
+    // Seeking into the middle matches walking from the start
+    auto all = firstN(lastWeekday, 120);
+    vector<system_clock::time_point> window;
+    for (auto t : lastWeekday.occurrencesBetween(makeTime(2030, 6, 15), makeTime(2031, 6, 15)))
+        window.push_back(t);
+    vector<system_clock::time_point> filtered;
+    for (auto t : all)
+        if (t >= makeTime(2030, 6, 15) && t < makeTime(2031, 6, 15))
+            filtered.push_back(t);
+    assert(window == filtered && window.size() == 12);
+
+    assert(rejects("FREQ=HOURLY"));
+    assert(rejects("INTERVAL=2"));
+    assert(rejects("FREQ=WEEKLY;BYDAY=1MO"));
+    assert(rejects("FREQ=DAILY;COUNT=2;UNTIL=20250101"));
+    assert(rejects("FREQ=DAILY;BYDAY=XX"));
+    assert(rejects("FREQ=DAILY;BYHOUR=9"));
+    assert(rejects("FREQ=MONTHLY;BYMONTHDAY=32"));
+}
+
+static void checkSame(const RecurrencePattern &expected, const RecurrencePattern &actual,
+                      const vector<system_clock::time_point> &seeks)
+{
+    assert(firstN(expected, 500) == firstN(actual, 500));
+    for (auto after : seeks)
+        assert(expected.getNextNOccurrences(after, 40) == actual.getNextNOccurrences(after, 40));
+    assert(expected.lastOccurrenceBound() == actual.lastOccurrenceBound());
+}
+
+void testRRuleMatchesPatterns()
+{
+    vector<system_clock::time_point> seeks = {makeTime(1990, 1, 1), makeTime(2003, 7, 4, 9), makeTime(2010, 2, 28, 23),
+                                              makeTime(2024, 12, 31, 12, 0, 1), makeTime(2100, 1, 1)};
+
+    auto start = makeTime(2003, 1, 1, 8, 30);
+    checkSame(DailyRecurrence(start, 3, 200), RRuleRecurrence(start, "FREQ=DAILY;INTERVAL=3;COUNT=200"), seeks);
+    // WeeklyRecurrence counts weeks from Sunday
+    checkSame(WeeklyRecurrence(start, {Weekday::Monday, Weekday::Wednesday, Weekday::Friday}, 2),
+              RRuleRecurrence(start, "FREQ=WEEKLY;INTERVAL=2;BYDAY=MO,WE,FR;WKST=SU"), seeks);
+    auto end = makeTime(2030, 3, 1);
+    checkSame(MonthlyRecurrence(makeTime(2001, 1, 15, 9), 2, -1, end),
+              RRuleRecurrence(makeTime(2001, 1, 15, 9), "FREQ=MONTHLY;INTERVAL=2;UNTIL=20300301T000000Z"), seeks);
+    checkSame(YearlyRecurrence(makeTime(2000, 3, 10, 7), 1, 50),
+              RRuleRecurrence(makeTime(2000, 3, 10, 7), "FREQ=YEARLY;COUNT=50"), seeks);
+}
+
+void testRRuleExpansionCounts()
+{
+    // Timings for these live in benchmark.cpp (--recurrence)
+    auto start = makeTime(2000, 1, 3, 9);
+    auto from = makeTime(2020, 1, 1);
+    auto to = makeTime(2030, 1, 1);
+    WeeklyRecurrence weekly(start, {Weekday::Monday, Weekday::Tuesday, Weekday::Wednesday, Weekday::Thursday,
+                                    Weekday::Friday}, 1);
+    RRuleRecurrence rrule(start, "FREQ=WEEKLY;BYDAY=MO,TU,WE,TH,FR;WKST=SU");
+    RRuleRecurrence lastWeekday(start, "FREQ=MONTHLY;BYDAY=MO,TU,WE,TH,FR;BYSETPOS=-1");
+
+    auto count = [&](const RecurrencePattern &p) {
+        size_t n = 0;
+        for (auto t : p.occurrencesBetween(from, to))
+        {
+            (void)t;
+            ++n;
+        }
+        return n;
+    };
+    assert(count(weekly) == 2609 && count(rrule) == 2609);
+    assert(count(lastWeekday) == 120);
+}
+
 int main()
 {
     testDailyRecurrence();
@@ -170,6 +451,11 @@ int main()
     testYearlyRecurrence();
     testDailyRecurrenceDST();
     testRecurringCrossTimeZones();
+    testSeekMatchesWalk();
+    testOccurrencesBetween();
+    testRRuleConformance();
+    testRRuleMatchesPatterns();
+    testRRuleExpansionCounts();
     std::cout << "All recurrence tests passed\n";
     return 0;
 }
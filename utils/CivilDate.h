@@ -0,0 +1,87 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+// Proleptic Gregorian calendar arithmetic on days since the epoch (UTC).
+// Recurrence patterns use it to jump straight to the Nth occurrence
+// instead of stepping through gmtime/timegm one occurrence at a time.
+namespace CivilDate {
+
+constexpr int64_t kSecondsPerDay = 86400;
+
+// Division rounding toward negative infinity
+inline int64_t floorDiv(int64_t a, int64_t b) {
+    int64_t q = a / b;
+    return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+}
+
+inline bool isLeap(int64_t year) {
+    return (year % 4 == 0 && year % 100 != 0) || (year % 400 == 0);
+}
+
+inline int daysInMonth(int64_t year, int month) {
+    static const int days[] = {31,28,31,30,31,30,31,31,30,31,30,31};
+    if (month == 2)
+        return days[1] + (isLeap(year) ? 1 : 0);
+    return days[month - 1];
+}
+
+// Days since 1970-01-01 of year/month(1-12)/day
+inline int64_t daysFromCivil(int64_t year, int month, int day) {
+    year -= month <= 2;
+    int64_t era = floorDiv(year, 400);
+    int64_t yoe = year - era * 400;
+    int64_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+inline void civilFromDays(int64_t days, int64_t &year, int &month, int &day) {
+    days += 719468;
+    int64_t era = floorDiv(days, 146097);
+    int64_t doe = days - era * 146097;
+    int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int64_t mp = (5 * doy + 2) / 153;
+    day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    year = yoe + era * 400 + (month <= 2);
+}
+
+// Calendar date and seconds into the day of `seconds` since the epoch
+inline void civilFromSeconds(int64_t seconds, int64_t &year, int &month, int &day, int64_t &timeOfDay) {
+    int64_t days = floorDiv(seconds, kSecondsPerDay);
+    timeOfDay = seconds - days * kSecondsPerDay;
+    civilFromDays(days, year, month, day);
+}
+
+// A time point as whole seconds since the epoch (floored) plus the
+// non-negative remainder, so it can be compared without overflowing.
+struct SplitTime {
+    int64_t seconds;
+    std::chrono::system_clock::duration frac;
+};
+
+inline SplitTime split(std::chrono::system_clock::time_point tp) {
+    auto secs = std::chrono::floor<std::chrono::seconds>(tp.time_since_epoch());
+    return {secs.count(), tp.time_since_epoch() - secs};
+}
+
+// Whether `seconds` plus any sub-second remainder still fits a time_point
+inline bool representable(int64_t seconds) {
+    static const int64_t maxSeconds =
+        std::chrono::floor<std::chrono::seconds>(std::chrono::system_clock::time_point::max().time_since_epoch())
+            .count() - 1;
+    return seconds <= maxSeconds;
+}
+
+inline std::chrono::system_clock::time_point join(int64_t seconds, std::chrono::system_clock::duration frac) {
+    return std::chrono::system_clock::time_point(std::chrono::seconds(seconds)) + frac;
+}
+
+// True when seconds + frac lies after `t`
+inline bool later(int64_t seconds, std::chrono::system_clock::duration frac, const SplitTime &t) {
+    return seconds > t.seconds || (seconds == t.seconds && frac > t.frac);
+}
+
+}
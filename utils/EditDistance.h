@@ -0,0 +1,105 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+  Bounded Levenshtein distance: answers "is levenshtein(pattern, text) at
+  most k?" for one pattern against many texts.
+
+  Patterns up to 64 characters use the bit-parallel algorithm of Myers as
+  formulated by Hyyrö for global distance: one column of the DP table is
+  held as +1/-1 vertical deltas in two machine words, so each text character
+  costs a handful of word operations instead of m cell updates, and nothing
+  is allocated. The bottom-row score can fall by at most one per remaining
+  character, which gives the early exit. Longer patterns fall back to the
+  row-by-row DP, stopping once a whole row exceeds k.
+
+  The per-character match masks are built once in the constructor, so reuse
+  one instance across candidates.
+*/
+class BoundedEditDistance
+{
+public:
+    static constexpr size_t kWordBits = 64;
+
+    explicit BoundedEditDistance(const std::string &pattern)
+        : pattern_(pattern)
+    {
+        if (pattern_.size() > kWordBits)
+            return;
+        for (size_t i = 0; i < pattern_.size(); ++i)
+            peq_[static_cast<unsigned char>(pattern_[i])] |= uint64_t(1) << i;
+    }
+
+    const std::string &pattern() const { return pattern_; }
+
+    // True when levenshtein(pattern, text) <= maxDistance.
+    bool within(const std::string &text, size_t maxDistance) const
+    {
+        const size_t m = pattern_.size(), n = text.size();
+        if ((m > n ? m - n : n - m) > maxDistance)
+            return false;
+        if (m == 0)
+            return true; // distance is n, already bounded above
+        if (m > kWordBits)
+            return withinByRows(text, maxDistance);
+
+        const uint64_t last = uint64_t(1) << (m - 1);
+        uint64_t pv = ~uint64_t(0), mv = 0;
+        size_t score = m;
+        for (size_t j = 0; j < n; ++j)
+        {
+            const uint64_t eq = peq_[static_cast<unsigned char>(text[j])];
+            const uint64_t xv = eq | mv;
+            const uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+            uint64_t ph = mv | ~(xh | pv);
+            uint64_t mh = pv & xh;
+            if (ph & last)
+                ++score;
+            else if (mh & last)
+                --score;
+            // Row 0 grows by one per column in the global distance
+            ph = (ph << 1) | 1;
+            mh <<= 1;
+            pv = mh | ~(xv | ph);
+            mv = ph & xv;
+            if (score > maxDistance + (n - j - 1))
+                return false;
+        }
+        return score <= maxDistance;
+    }
+
+private:
+    std::string pattern_;
+    std::array<uint64_t, 256> peq_{};
+
+    bool withinByRows(const std::string &text, size_t maxDistance) const
+    {
+        const size_t n = text.size();
+        std::vector<size_t> prev(n + 1), row(n + 1);
+        for (size_t j = 0; j <= n; ++j)
+            prev[j] = j;
+        for (size_t i = 0; i < pattern_.size(); ++i)
+        {
+            row[0] = i + 1;
+            size_t best = row[0];
+            for (size_t j = 0; j < n; ++j)
+            {
+                row[j + 1] = std::min({prev[j + 1] + 1,
+                                       row[j] + 1,
+                                       prev[j] + (pattern_[i] == text[j] ? 0 : 1)});
+                best = std::min(best, row[j + 1]);
+            }
+            // A row's minimum never decreases further down
+            if (best > maxDistance)
+                return false;
+            prev.swap(row);
+        }
+        return prev[n] <= maxDistance;
+    }
+};
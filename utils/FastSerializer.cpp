@@ -1,33 +1,69 @@
 #include "FastSerializer.h"
+#include "TimeUtils.h"
 
 std::string FastSerializer::serializeEvent(const Event& event) {
-    std::ostringstream ss;
-    ss << R"({"id":")" << event.getId() 
-       << R"(","title":")" << escapeJson(event.getTitle())
-       << R"(","description":")" << escapeJson(event.getDescription())
-       << R"(","time":")" << formatTime(event.getTime())
-       << R"(","duration":)" << std::chrono::duration_cast<std::chrono::seconds>(event.getDuration()).count()
-       << R"(,"category":")" << escapeJson(event.getCategory())
-       << R"(","recurring":)" << (event.isRecurring() ? "true" : "false")
-       << "}";
-    return ss.str();
+    std::string out;
+    appendEvent(out, event);
+    return out;
 }
 
 std::string FastSerializer::serializeEvents(const std::vector<Event>& events) {
-    if (events.empty()) {
-        return R"({"status":"ok","data":[]})";
+    std::string out;
+    out.reserve(32 + events.size() * 160);
+    out += R"({"status":"ok","data":[)";
+    for (size_t i = 0; i < events.size(); ++i) {
+        if (i > 0) out += ',';
+        appendEvent(out, events[i]);
     }
-    
-    std::ostringstream ss;
-    ss << R"({"status":"ok","data":[)";
-    
+    out += "]}";
+    return out;
+}
+
+std::string FastSerializer::serializeEvents(const std::vector<std::shared_ptr<const Event>>& events) {
+    std::string out;
+    out.reserve(32 + events.size() * 160);
+    out += R"({"status":"ok","data":[)";
     for (size_t i = 0; i < events.size(); ++i) {
-        if (i > 0) ss << ",";
-        ss << serializeEvent(events[i]);
+        if (i > 0) out += ',';
+        appendEvent(out, *events[i]);
     }
-    
-    ss << "]}";
-    return ss.str();
+    out += "]}";
+    return out;
+}
+
+std::string FastSerializer::serializeOccurrences(const std::vector<Occurrence>& occurrences) {
+    std::string out;
+    out.reserve(32 + occurrences.size() * 160);
+    out += R"({"status":"ok","data":[)";
+    for (size_t i = 0; i < occurrences.size(); ++i) {
+        if (i > 0) out += ',';
+        appendEvent(out, occurrences[i].event(), occurrences[i].start);
+    }
+    out += "]}";
+    return out;
+}
+
+void FastSerializer::appendEvent(std::string& out, const Event& event) {
+    appendEvent(out, event, event.getTime());
+}
+
+// Writes one event object into `out`; the only allocations are `out` growing
+void FastSerializer::appendEvent(std::string& out, const Event& event, std::chrono::system_clock::time_point start) {
+    out += R"({"id":")";
+    appendEscaped(out, event.getId());
+    out += R"(","title":")";
+    appendEscaped(out, event.getTitle());
+    out += R"(","description":")";
+    appendEscaped(out, event.getDescription());
+    out += R"(","time":")";
+    TimeUtils::appendTimePoint(out, start);
+    out += R"(","duration":)";
+    out += std::to_string(std::chrono::duration_cast<std::chrono::seconds>(event.getDuration()).count());
+    out += R"(,"category":")";
+    appendEscaped(out, event.getCategory());
+    out += R"(","recurring":)";
+    out += event.isRecurring() ? "true" : "false";
+    out += '}';
 }
 
 std::string FastSerializer::successResponse(const std::string& data) {
@@ -119,29 +155,32 @@ std::string FastSerializer::serializeStats(const EventStats& stats) {
 std::string FastSerializer::escapeJson(const std::string& str) {
     std::string result;
     result.reserve(str.length() + str.length() / 4); // Reserve extra space for escapes
-    
+    appendEscaped(result, str);
+    return result;
+}
+
+void FastSerializer::appendEscaped(std::string& out, const std::string& str) {
     for (char c : str) {
         switch (c) {
-            case '"': result += R"(\")"; break;
-            case '\\': result += R"(\\)"; break;
-            case '\n': result += R"(\n)"; break;
-            case '\r': result += R"(\r)"; break;
-            case '\t': result += R"(\t)"; break;
-            case '\b': result += R"(\b)"; break;
-            case '\f': result += R"(\f)"; break;
+            case '"': out += R"(\")"; break;
+            case '\\': out += R"(\\)"; break;
+            case '\n': out += R"(\n)"; break;
+            case '\r': out += R"(\r)"; break;
+            case '\t': out += R"(\t)"; break;
+            case '\b': out += R"(\b)"; break;
+            case '\f': out += R"(\f)"; break;
             default: 
                 if (static_cast<unsigned char>(c) < 0x20) {
                     // Control characters
-                    result += "\\u00";
-                    result += "0123456789abcdef"[(c >> 4) & 0xF];
-                    result += "0123456789abcdef"[c & 0xF];
+                    out += "\\u00";
+                    out += "0123456789abcdef"[(c >> 4) & 0xF];
+                    out += "0123456789abcdef"[c & 0xF];
                 } else {
-                    result += c;
+                    out += c;
                 }
                 break;
         }
     }
-    return result;
 }
 
 std::string FastSerializer::formatTime(std::chrono::system_clock::time_point tp) {
@@ -2,12 +2,14 @@
 
 #include "../model/Event.h"
 #include "../model/Model.h"  // For TimeSlot and EventStats
+#include "../model/Occurrence.h"
 #include <string>
 #include <vector>
 #include <sstream>
 #include <iomanip>
 #include <chrono>
 #include <map>
+#include <memory>
 
 class FastSerializer {
 public:
@@ -16,6 +18,10 @@ public:
     
     // Batch serialize events for better performance
     static std::string serializeEvents(const std::vector<Event>& events);
+    // Same output, serialized straight from borrowed model events
+    static std::string serializeEvents(const std::vector<std::shared_ptr<const Event>>& events);
+    // Expanded schedule; each entry's text is read from its series
+    static std::string serializeOccurrences(const std::vector<Occurrence>& occurrences);
     
     // Pre-computed response templates
     static std::string successResponse(const std::string& data);
@@ -45,5 +51,8 @@ public:
 
 private:
     static std::string escapeJson(const std::string& str);
+    static void appendEscaped(std::string& out, const std::string& str);
+    static void appendEvent(std::string& out, const Event& event);
+    static void appendEvent(std::string& out, const Event& event, std::chrono::system_clock::time_point start);
     static std::string formatTime(std::chrono::system_clock::time_point tp);
 };
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+
+/*
+  Time-ordered event IDs in the style of ULID.
+  An ID is 128 bits written as 26 lowercase base32hex digits (RFC 4648
+  0-9a-v, which is all Google Calendar accepts in an event ID):
+    48 bits  milliseconds since the Unix epoch
+    16 bits  sequence within that millisecond
+    64 bits  node, drawn at random once per process
+  Time and sequence come from one atomic counter advanced by compare-and-swap,
+  so IDs from one process are strictly increasing and never repeat, with no
+  lock and no lookup against existing events. When more than 65536 IDs are
+  requested in a millisecond, or the clock steps back, the counter simply
+  runs ahead of the clock. The node bits keep separate processes sharing a
+  database apart.
+
+  Fixed width makes string order equal creation order, so new rows land at
+  the right-hand edge of SQLite's primary key B-tree.
+*/
+class IdGenerator
+{
+public:
+    static constexpr size_t kLength = 26;
+
+    static std::string next()
+    {
+        const uint64_t hi = nextTick();
+        const uint64_t lo = node();
+        static const char digits[] = "0123456789abcdefghijklmnopqrstuv";
+
+        std::string id(kLength, '0');
+        for (size_t i = 0; i < kLength; ++i)
+        {
+            const size_t bit = 5 * i;
+            uint64_t v;
+            if (bit + 5 <= 64)
+                v = lo >> bit;
+            else if (bit < 64)
+                v = (lo >> bit) | (hi << (64 - bit));
+            else
+                v = hi >> (bit - 64);
+            id[kLength - 1 - i] = digits[v & 31];
+        }
+        return id;
+    }
+
+private:
+    static constexpr int kSequenceBits = 16;
+
+    // Milliseconds << kSequenceBits | sequence, strictly increasing
+    static uint64_t nextTick()
+    {
+        static std::atomic<uint64_t> last{0};
+        const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::system_clock::now().time_since_epoch())
+                            .count();
+        const uint64_t now = static_cast<uint64_t>(ms) << kSequenceBits;
+        uint64_t prev = last.load(std::memory_order_relaxed);
+        uint64_t next;
+        do
+        {
+            next = std::max(now, prev + 1);
+        } while (!last.compare_exchange_weak(prev, next, std::memory_order_relaxed));
+        return next;
+    }
+
+    static uint64_t node()
+    {
+        static const uint64_t bits = []
+        {
+            std::random_device rd;
+            return (static_cast<uint64_t>(rd()) << 32) ^ rd();
+        }();
+        return bits;
+    }
+};
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/*
+  Process-wide pool of interned strings.
+  Low-cardinality names (categories, notifier and action names) repeat across
+  thousands of events; storing a 4-byte handle instead of a std::string keeps
+  events small and makes copying them allocation-free. Interned strings are
+  never released, so a handle and the reference returned by str() stay valid
+  for the life of the process. Do not intern per-event values such as IDs.
+
+  intern() takes a shared lock for the common hit path and an exclusive one
+  only to add a new string; str() does not lock at all.
+*/
+class InternPool
+{
+public:
+    using Handle = uint32_t;
+
+    // Handle of the empty string; a default-initialised handle means "".
+    static constexpr Handle kEmpty = 0;
+
+    static Handle intern(std::string_view s)
+    {
+        auto &st = state();
+        {
+            std::shared_lock<std::shared_mutex> lock(st.mutex);
+            auto found = st.handles.find(s);
+            if (found != st.handles.end())
+                return found->second;
+        }
+        std::unique_lock<std::shared_mutex> lock(st.mutex);
+        auto found = st.handles.find(s);
+        if (found != st.handles.end())
+            return found->second;
+        return st.add(s);
+    }
+
+    static const std::string &str(Handle h)
+    {
+        auto &st = state();
+        return st.segments[h >> kSegmentBits].load(std::memory_order_acquire)[h & (kSegmentSize - 1)];
+    }
+
+    // Number of distinct strings interned so far (including "").
+    static size_t size()
+    {
+        auto &st = state();
+        std::shared_lock<std::shared_mutex> lock(st.mutex);
+        return st.count;
+    }
+
+private:
+    // Strings live in fixed-size segments that never move, so str() can
+    // index them while another thread appends.
+    static constexpr size_t kSegmentBits = 10;
+    static constexpr size_t kSegmentSize = size_t(1) << kSegmentBits;
+    static constexpr size_t kMaxSegments = 4096;
+
+    struct State
+    {
+        std::shared_mutex mutex;
+        std::unordered_map<std::string_view, Handle> handles; // views into segments
+        std::array<std::atomic<std::string *>, kMaxSegments> segments{};
+        std::array<std::unique_ptr<std::string[]>, kMaxSegments> owned;
+        size_t count = 0;
+
+        State() { add(std::string_view()); }
+
+        // Caller holds mutex exclusively.
+        Handle add(std::string_view s)
+        {
+            size_t seg = count >> kSegmentBits;
+            if (seg >= kMaxSegments)
+                throw std::length_error("InternPool is full");
+            if (!owned[seg])
+            {
+                owned[seg] = std::make_unique<std::string[]>(kSegmentSize);
+                segments[seg].store(owned[seg].get(), std::memory_order_release);
+            }
+            std::string &slot = owned[seg][count & (kSegmentSize - 1)];
+            slot.assign(s.data(), s.size());
+            Handle h = static_cast<Handle>(count++);
+            handles.emplace(std::string_view(slot), h);
+            return h;
+        }
+    };
+
+    static State &state()
+    {
+        static State st;
+        return st;
+    }
+};
@@ -6,7 +6,8 @@
 #include <ctime>
 
 namespace TimeUtils {
-inline std::string formatTimePoint(const std::chrono::system_clock::time_point &tp) {
+// Appends the formatTimePoint() text to `out` without a temporary string
+inline void appendTimePoint(std::string &out, const std::chrono::system_clock::time_point &tp) {
     using namespace std::chrono;
     time_t t_c = system_clock::to_time_t(tp);
     std::tm tm_buf;
@@ -16,8 +17,14 @@ inline std::string formatTimePoint(const std::chrono::system_clock::time_point &
     localtime_r(&t_c, &tm_buf);
 #endif
     char buf[32];
-    strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M", &tm_buf);
-    return std::string(buf);
+    size_t n = strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M", &tm_buf);
+    out.append(buf, n);
+}
+
+inline std::string formatTimePoint(const std::chrono::system_clock::time_point &tp) {
+    std::string out;
+    appendTimePoint(out, tp);
+    return out;
 }
 
 inline std::chrono::system_clock::time_point parseTimePoint(const std::string &timestamp) {